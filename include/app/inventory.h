@@ -3,6 +3,18 @@
 
 #include "list/XArrayList.h"
 #include "list/DLinkedList.h"
+#include "hash/xMap.h"
+#include "util/Bitmap.h"
+#include "util/RangeFilter.h"
+#include "heap/Heap.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <memory.h>
+#include <cmath>
+#include <climits>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -13,6 +25,8 @@ using namespace std;
 
 template<typename T> class List1D;
 template<typename T> class List2D;
+class InventoryView;
+class QueryBuilder;
 template<typename T>
 inline ostream& operator<<(ostream& os, const List1D<T>& list);
 
@@ -31,16 +45,21 @@ public:
     List1D(int num_elements);
     List1D(const T *array, int num_elements);
     List1D(const List1D<T> &other);
+    List1D(List1D<T> &&other); // takes other's list; other is left empty
     virtual ~List1D();
 
     int size() const;
     T get(int index) const;
     void set(int index, T value);
     void add(const T &value);
+    void add(T &&value);
     string toString() const;
 
     friend ostream& operator<< <T>(ostream& os, const List1D<T>& list);
     List1D<T> &operator=(const List1D<T> &list);
+    List1D<T> &operator=(List1D<T> &&list);
+
+    friend class List2D<T>;
 };
 
 // -------------------- List2D --------------------
@@ -54,24 +73,162 @@ public:
     List2D();
     List2D(List1D<T> *array, int num_rows);
     List2D(const List2D<T> &other);
+    List2D(List2D<T> &&other); // takes other's rows; other is left empty
     virtual ~List2D();
 
     int rows() const;
     void setRow(int rowIndex, const List1D<T> &row);
+    void setRow(int rowIndex, List1D<T> &&row); // takes row's list, no copy
     T get(int rowIndex, int colIndex) const;
     List1D<T> getRow(int rowIndex) const;
     string toString() const;
 
     friend ostream& operator<< <T>(ostream& os, const List2D<T>& matrix);
     List2D<T> &operator=(const List2D<T> &matrix);
+    List2D<T> &operator=(List2D<T> &&matrix);
+};
+
+// -------------------- AttributeNames --------------------
+/*
+ * AttributeNames: the global symbol table of attribute names.
+ *  + intern(name): the id of name, a new one (0, 1, 2, ...) the first time;
+ *  + nameOf(id)  : the name back.
+ * Id 0 is the empty name. Ids are never reused, so an id stays valid for
+ * the life of the program and two attributes have the same name iff they
+ * have the same id. The table is shared by all inventories; intern and
+ * find take its mutex. nameOf does not: the names are kept in chunks of
+ * 64, 128, 256, ... slots that are never moved once allocated, and a
+ * name is published (release) before the count that makes its id valid.
+ */
+class AttributeNames
+{
+public:
+    static int intern(const string &name);
+    static int find(const string &name); // -1 if name was never interned
+    static const string &nameOf(int id);
+    static int count();
+    // FNV-1a of a name, for an xMap keyed by strings
+    static int hashName(string &name, int capacity)
+    {
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < name.length(); i++) {
+            hash ^= (unsigned char)name[i];
+            hash *= 16777619u;
+        }
+        return (int)(hash % (unsigned int)capacity);
+    }
+
+private:
+    static const int FIRST_CHUNK_BITS = 6; // chunk c holds 64 << c names
+    static const int MAX_CHUNKS = 32 - FIRST_CHUNK_BITS;
+
+    struct Table
+    {
+        xMap<string, int> ids;
+        atomic<const string *> *chunks[MAX_CHUNKS]; // by id; written under lock
+        atomic<int> size;
+        mutex lock;
+        Table() : ids(&AttributeNames::hashName), size(0)
+        {
+            for (int c = 0; c < MAX_CHUNKS; c++) {
+                chunks[c] = nullptr;
+            }
+            add(""); // id 0: the empty name (default attribute)
+        }
+        ~Table()
+        {
+            int n = size.load(memory_order_relaxed);
+            for (int id = 0; id < n; id++) {
+                delete slot(id).load(memory_order_relaxed);
+            }
+            for (int c = 0; c < MAX_CHUNKS; c++) {
+                delete[] chunks[c];
+            }
+        }
+        // the slot of id; its chunk must be allocated
+        atomic<const string *> &slot(int id)
+        {
+            unsigned int at = (unsigned int)id + (1u << FIRST_CHUNK_BITS);
+            int c = 31 - __builtin_clz(at) - FIRST_CHUNK_BITS;
+            return chunks[c][at - (1u << (c + FIRST_CHUNK_BITS))];
+        }
+        // a new id for name; called under lock (or from the constructor)
+        int add(const string &name)
+        {
+            int id = size.load(memory_order_relaxed);
+            unsigned int at = (unsigned int)id + (1u << FIRST_CHUNK_BITS);
+            int c = 31 - __builtin_clz(at) - FIRST_CHUNK_BITS;
+            if (c >= MAX_CHUNKS) {
+                throw length_error("Too many attribute names!");
+            }
+            if (chunks[c] == nullptr) {
+                chunks[c] = new atomic<const string *>[(size_t)1 << (c + FIRST_CHUNK_BITS)];
+            }
+            slot(id).store(new string(name), memory_order_relaxed);
+            ids.put(name, id);
+            size.store(id + 1, memory_order_release);
+            return id;
+        }
+    };
+    static Table &table()
+    {
+        static Table instance;
+        return instance;
+    }
+};
+
+// -------------------- AttributeName --------------------
+/*
+ * AttributeName: an interned attribute name, 4 bytes.
+ *      Compares as an int; reads as the string it stands for.
+ */
+class AttributeName
+{
+private:
+    int id;
+
+public:
+    AttributeName() : id(0) {} // "", interned by the table itself
+    AttributeName(const string &name) : id(AttributeNames::intern(name)) {}
+    AttributeName(const char *name) : id(AttributeNames::intern(name)) {}
+    static AttributeName fromId(int id)
+    {
+        AttributeName name;
+        name.id = id;
+        return name;
+    }
+
+    int getId() const { return id; }
+    const string &str() const { return AttributeNames::nameOf(id); }
+    operator const string &() const { return str(); }
+    size_t length() const { return str().length(); }
+    const char *c_str() const { return str().c_str(); }
+
+    bool operator==(const AttributeName &other) const { return id == other.id; }
+    bool operator!=(const AttributeName &other) const { return id != other.id; }
+    // comparing with a plain string must not intern it
+    bool operator==(const string &other) const { return str() == other; }
+    bool operator!=(const string &other) const { return str() != other; }
+    bool operator==(const char *other) const { return str() == other; }
+    bool operator!=(const char *other) const { return str() != other; }
+
+    friend string operator+(const AttributeName &name, const string &other) { return name.str() + other; }
+    friend string operator+(const string &other, const AttributeName &name) { return other + name.str(); }
+    friend string operator+(const AttributeName &name, const char *other) { return name.str() + other; }
+    friend string operator+(const char *other, const AttributeName &name) { return other + name.str(); }
+    friend ostream &operator<<(ostream &os, const AttributeName &name)
+    {
+        os << name.str();
+        return os;
+    }
 };
 
 struct InventoryAttribute
 {
-    string name;
+    AttributeName name;
     double value;
     InventoryAttribute() {};
-    InventoryAttribute(const string &name, double value) : name(name), value(value) {}
+    InventoryAttribute(const AttributeName &name, double value) : name(name), value(value) {}
     string toString() const { return name + ": " + to_string(value); }
     
     friend ostream &operator<<(ostream &os, const InventoryAttribute &attr)
@@ -86,13 +243,359 @@ struct InventoryAttribute
     }
 };
 
+// -------------------- InventoryColumns --------------------
+/*
+ * InventoryColumns: columnar (struct-of-arrays) storage of the products.
+ *  + names, quantities: one contiguous array each, indexed by slot;
+ *  + one Column per attribute name: a dense array of values (one per slot,
+ *    0 where the product has no such attribute) and a validity bitmap;
+ *  + firstColumn: attribute name id (see AttributeNames) -> its column.
+ * A scan over one attribute reads one array from start to end instead of
+ * visiting every product's own list.
+ *
+ * A product may repeat an attribute name: its k-th occurrence is stored in
+ * the k-th column of that name (columns of one name are chained by "next").
+ * rowColumns lists the column ids of every slot in attribute order, so a
+ * product is rebuilt exactly as it was added:
+ *      slot s: rowColumns[rowStart[s] .. rowStart[s + 1])
+ *
+ * Rows and slots: removing a product only clears its bit in "live" (a
+ * tombstone); its slot is reclaimed later, when more than
+ * MAX_DEAD_FRACTION of the slots are dead, by one compaction of all the
+ * arrays. Methods taking a "row" use the numbering of the live products
+ * (0 .. rows() - 1); raw arrays (getNames, getQuantities, Column, index
+ * entries) are indexed by slot. slotOf/rowOfSlot translate in O(log n)
+ * with a Fenwick tree over the live counts of the words of "live", and in
+ * O(1) while there is no tombstone.
+ *
+ * Secondary indexes: sortedIndex(nameId) is every (value, slot) of one
+ * attribute name, sorted by value then slot; NaN values are left out (no
+ * range holds them, and they have no order). It is built on first use and
+ * kept sorted by addRow and compaction afterwards (entries of dead slots
+ * stay until the compaction: check isLive). A copy of the storage starts
+ * without indexes and builds its own on demand. The build on first use is
+ * guarded by indexLock, so const methods stay safe to call from several
+ * threads at once.
+ *
+ * Name index, built on first use (under indexLock too) and kept the same
+ * way: slotsNamed(name) is the slots of one name in increasing order
+ * (xMap: O(1) expected), and slotsByName() every slot sorted by name then
+ * slot, where the names with a given prefix are one range (prefixRange).
+ *
+ * Bulk appends (beginBulk .. endBulk, only addRow/appendSlot in between):
+ * the entries of the new slots are appended to the built indexes unsorted,
+ * then sorted and merged in once by endBulk - the new slots are greater
+ * than all the others, so they are exactly the tail of each index.
+ */
+class InventoryColumns
+{
+public:
+    class Column; // forward declaration
+    class IndexEntry; // forward declaration
+    static constexpr double MAX_DEAD_FRACTION = 0.25;
+
+private:
+    XArrayList<int> firstColumn;    // attribute name id -> first column of that name, -1: none
+    XArrayList<Column *> columns;
+    XArrayList<string> names;
+    XArrayList<int> quantities;
+    XArrayList<int> rowStart;       // slotCount() + 1 offsets into rowColumns
+    XArrayList<int> rowColumns;
+    Bitmap live;                    // live.get(s): slot s holds a product
+    int deadCount;
+    XArrayList<int> liveTree;       // Fenwick tree, only kept while deadCount > 0
+    mutable XArrayList<XArrayList<IndexEntry> *> indexes; // by name id, 0: not built yet
+    mutable mutex indexLock;                               // guards the lazy builds
+    mutable xMap<string, int> *nameIds;                   // name -> its list in nameSlots, nullptr: not built yet
+    mutable XArrayList<XArrayList<int> *> nameSlots;
+    mutable XArrayList<int> *sortedNames;                  // nullptr: not built yet
+    int bulkFrom;                   // first slot of the bulk append, -1: none
+
+public:
+    InventoryColumns();
+    InventoryColumns(const InventoryColumns &other);
+    InventoryColumns(InventoryColumns &&other); // other is left empty
+    InventoryColumns &operator=(const InventoryColumns &other);
+    InventoryColumns &operator=(InventoryColumns &&other);
+    ~InventoryColumns();
+
+    int rows() const;
+    void addRow(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    void addRow(const InventoryAttribute *attributes, int count, const string &name, int quantity);
+    void removeRow(int row);
+    void removeRows(const int *rows, int count); // rows numbered before the call
+    void compact(const Bitmap &keep); // keep the rows r with keep.get(r), in order
+    void purge();                     // reclaim the dead slots now
+    void clear();
+
+    List1D<InventoryAttribute> getRow(int row) const;
+    const string &getName(int row) const;
+    int getQuantity(int row) const;
+    void setQuantity(int row, int quantity);
+
+    // slots: 0 .. slotCount() - 1, dead ones included
+    int slotCount() const;
+    bool isLive(int slot) const;
+    int slotOf(int row) const;
+    int rowOfSlot(int slot) const; // slot must be live
+    const Bitmap &getLive() const;
+
+    // contiguous per-slot arrays, slotCount() items each
+    const XArrayList<string> &getNames() const;
+    const XArrayList<int> &getQuantities() const;
+    // slot s: getRowColumns()[getRowStarts()[s] .. getRowStarts()[s + 1])
+    const XArrayList<int> &getRowStarts() const;
+    const XArrayList<int> &getRowColumns() const;
+
+    // column ids of a row, in attribute order
+    int rowSize(int row) const;
+    int rowColumn(int row, int k) const;
+    // rowHash/sameRow: same name, same attribute names in the same order
+    // and the same values
+    unsigned long long rowHash(int row) const;
+    bool sameRow(int row1, int row2) const;
+
+    int columnCount() const;
+    int findColumn(const string &attributeName) const; // -1 if no row has it
+    int findColumn(int nameId) const;
+    Column &column(int id) const;
+
+    const XArrayList<IndexEntry> &sortedIndex(int nameId) const;
+    const XArrayList<int> *slotsNamed(const string &name) const; // nullptr: no such name
+    const XArrayList<int> &slotsByName() const;
+    // prefixRange: slotsByName()[first .. last) are the names starting with prefix
+    void prefixRange(const string &prefix, int &first, int &last) const;
+
+    // appending the slots of another storage, without going through
+    // List1D rows: mapColumns gives the column here of every column of
+    // "source" (new[], created when missing), appendSlot copies one slot
+    // with it - or moves its name out when "move" is set
+    void reserve(int slots, int cells);
+    int cellCount() const;
+    int *mapColumns(const InventoryColumns &source);
+    void appendSlot(InventoryColumns &source, int slot, const int *columnMap, bool move);
+    bool sameSlot(int slot, const InventoryColumns &other, int otherSlot) const;
+    void beginBulk();
+    void endBulk();
+
+private:
+    template <class Get>
+    void appendRow(int count, Get attribute, const string &name, int quantity);
+    int columnFor(int nameId, int slot);
+    void indexAdd(int nameId, double value, int slot, int id);
+    void nameIndexAdd(int slot);
+    void markDead(int slot);
+    void purgeIfNeeded();
+    void compactSlots(const Bitmap &keepSlots);
+    static void renumberSlots(XArrayList<int> &slots, const int *newSlot);
+    void buildLiveTree();
+    void addLive(int word, int delta);
+    int liveBefore(int word) const;
+    void buildIndex(int nameId) const;
+    void buildNameSlots() const;
+    void addNameSlot(const string &name, int slot) const;
+    void buildSortedNames() const;
+    void dropIndexes();
+    void copyFrom(const InventoryColumns &other);
+    void removeInternalData();
+
+public:
+    class Column
+    {
+    public:
+        AttributeName name;
+        int next;                   // next column with the same name, -1: none
+        XArrayList<double> values;  // one per slot
+        Bitmap valid;               // valid.get(s): slot s has this attribute
+
+        Column(const AttributeName &name, int slots)
+            : name(name), next(-1), values(0, 0, slots + 1), valid(slots)
+        {
+            for (int i = 0; i < slots; i++) {
+                values.add(0);
+            }
+        }
+    };
+
+    class IndexEntry
+    {
+    public:
+        double value;
+        int slot;
+        int column; // which column of the name holds it (repeated names)
+
+        IndexEntry() : value(0), slot(0), column(0) {}
+        IndexEntry(double value, int slot, int column) : value(value), slot(slot), column(column) {}
+        bool operator<(const IndexEntry &other) const
+        {
+            return value < other.value || (value == other.value && slot < other.slot);
+        }
+        bool operator==(const IndexEntry &other) const
+        {
+            return value == other.value && slot == other.slot && column == other.column;
+        }
+        friend ostream &operator<<(ostream &os, const IndexEntry &entry)
+        {
+            os << "(" << entry.value << ", " << entry.slot << ")";
+            return os;
+        }
+    };
+};
+
+// -------------------- AttributeSpan / NameView --------------------
+/*
+ * AttributeSpan: the attributes of one product, read in place from the
+ * columns (no List1D, no copy of the row): size(), get(k) / [k], and a
+ * range-for over InventoryAttribute values.
+ * NameView: the names of the live products, by row, as references into
+ * the names array.
+ * Both are views: any change to the products invalidates them.
+ */
+class AttributeSpan
+{
+private:
+    const InventoryColumns *store;
+    int slot;
+    const int *columnIds; // rowColumns of the slot
+    int length;
+
+public:
+    class Iterator; // forward declaration
+
+    AttributeSpan() : store(nullptr), slot(0), columnIds(nullptr), length(0) {}
+    AttributeSpan(const InventoryColumns &store, int row);
+
+    int size() const { return length; }
+    InventoryAttribute get(int k) const;
+    InventoryAttribute operator[](int k) const { return get(k); }
+    const AttributeName &nameAt(int k) const;
+    double valueAt(int k) const;
+    List1D<InventoryAttribute> toList() const;
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, length); }
+
+    class Iterator
+    {
+    private:
+        const AttributeSpan *span;
+        int cursor;
+
+    public:
+        Iterator(const AttributeSpan *span = 0, int index = 0) : span(span), cursor(index) {}
+        InventoryAttribute operator*() const { return span->get(cursor); }
+        bool operator!=(const Iterator &iterator) const { return cursor != iterator.cursor; }
+        Iterator &operator++()
+        {
+            cursor++;
+            return *this;
+        }
+    };
+};
+
+class NameView
+{
+private:
+    const InventoryColumns *store;
+
+public:
+    class Iterator; // forward declaration
+
+    NameView(const InventoryColumns &store) : store(&store) {}
+
+    int size() const;
+    const string &get(int row) const;
+    const string &operator[](int row) const { return get(row); }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    class Iterator
+    {
+    private:
+        const NameView *view;
+        int cursor;
+
+    public:
+        Iterator(const NameView *view = 0, int index = 0) : view(view), cursor(index) {}
+        const string &operator*() const { return view->get(cursor); }
+        bool operator!=(const Iterator &iterator) const { return cursor != iterator.cursor; }
+        Iterator &operator++()
+        {
+            cursor++;
+            return *this;
+        }
+    };
+};
+
+// -------------------- AttributeGroup --------------------
+// one bucket of InventoryManager::groupBy: the values in [low, high)
+struct AttributeGroup
+{
+    double low;
+    double high;
+    int count;          // values in the bucket
+    long long quantity; // sum of the quantities of their products
+
+    AttributeGroup() : low(0), high(0), count(0), quantity(0) {}
+    AttributeGroup(double low, double high) : low(low), high(high), count(0), quantity(0) {}
+    string toString() const
+    {
+        stringstream ss;
+        ss << "[" << low << ", " << high << "): " << count << " (" << quantity << ")";
+        return ss.str();
+    }
+    bool operator==(const AttributeGroup &other) const
+    {
+        return low == other.low && high == other.high && count == other.count && quantity == other.quantity;
+    }
+    friend ostream &operator<<(ostream &os, const AttributeGroup &group)
+    {
+        os << group.toString();
+        return os;
+    }
+};
+
+// -------------------- InventoryBatch --------------------
+/*
+ * InventoryBatch: add / update / remove operations, recorded for one
+ * InventoryManager::applyBatch. The operations are kept by kind, in
+ * contiguous arrays (the attributes of all the additions in one), so
+ * applying them copies no per-operation list.
+ * Indices are those of the inventory before the batch; the additions go
+ * to the end, in order. Several updates of a product: the last one wins;
+ * an update of a removed product is lost.
+ */
+class InventoryBatch
+{
+private:
+    XArrayList<InventoryAttribute> attributes; // of every addition, in order
+    XArrayList<int> attributeStart;            // addition i: attributes[start[i] .. start[i + 1])
+    XArrayList<string> names;
+    XArrayList<int> quantities;
+    XArrayList<int> updateIndices;
+    XArrayList<int> updateQuantities;
+    XArrayList<int> removeIndices;
+
+public:
+    InventoryBatch();
+
+    void add(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    void update(int index, int newQuantity);
+    void remove(int index);
+
+    int size() const; // number of operations
+    int additions() const;
+    void clear();
+
+    friend class InventoryManager;
+};
+
 // -------------------- InventoryManager --------------------
 class InventoryManager
 {
 private:
-    List2D<InventoryAttribute> attributesMatrix;
-    List1D<string> productNames;
-    List1D<int> quantities;
+    InventoryColumns store;
 
 public:
     InventoryManager();
@@ -100,26 +603,78 @@ public:
                      const List1D<string> &names,
                      const List1D<int> &quantities);
     InventoryManager(const InventoryManager &other);
+    InventoryManager(InventoryManager &&other); // other is left empty
 
     int size() const;
     List1D<InventoryAttribute> getProductAttributes(int index) const;
     string getProductName(int index) const;
     int getProductQuantity(int index) const;
+    // no-copy accessors: valid until the products change
+    AttributeSpan attributesOf(int index) const;
+    NameView names() const;
+    // name index (built on first use, then kept up to date): the indices
+    // of the products named "name", increasing, in O(1) expected + output;
+    // findByPrefix: the names starting with prefix, by name then index
+    List1D<int> findByName(const string &name) const;
+    List1D<int> findByPrefix(const string &prefix) const;
     void updateQuantity(int index, int newQuantity);
     void addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
     void removeProduct(int index);
+    void removeProducts(const List1D<int> &indices);
+    // applyBatch: all the operations of the batch (see InventoryBatch), or
+    // none if an index is invalid (out_of_range). One capacity
+    // reservation for the additions, the built indexes merged once, at
+    // most one compaction for the removals.
+    void applyBatch(const InventoryBatch &batch);
 
     List1D<string> query(string attributeName, const double &minValue,
                          const double &maxValue, int minQuantity, bool ascending) const;
+    // queryParallel: the result of query, with the candidates filtered by
+    // numThreads threads (0: one per hardware thread); sequential below
+    // PARALLEL_QUERY_MIN candidates
+    List1D<string> queryParallel(string attributeName, const double &minValue,
+                                 const double &maxValue, int minQuantity, bool ascending,
+                                 int numThreads = 0) const;
+    static constexpr int PARALLEL_QUERY_MIN = 1 << 15;
+    // dense query: candidates * DENSE_QUERY_RATIO >= slots (see queryRange)
+    static constexpr int DENSE_QUERY_RATIO = 16;
+
+    // aggregates over the values of one attribute (every occurrence, in
+    // [minValue, maxValue]) or over the quantities, in one pass over the
+    // columns, split over numThreads threads (0: hardware) from
+    // PARALLEL_QUERY_MIN products on. MIN/MAX/AVG of no value: NaN.
+    enum AggregateOp { SUM, MIN, MAX, AVG, COUNT };
+    double aggregate(const string &attributeName, AggregateOp op,
+                     double minValue = -INFINITY, double maxValue = INFINITY,
+                     int numThreads = 1) const;
+    double aggregateQuantity(AggregateOp op, int numThreads = 1) const;
+    // groupBy: histogram of the values of attributeName over "buckets"
+    // buckets of the given width from "start" (values outside: ignored)
+    List1D<AttributeGroup> groupBy(const string &attributeName, double start, double width,
+                                   int buckets, int numThreads = 1) const;
 
     void removeDuplicates();
 
     static InventoryManager merge(const InventoryManager &inv1,
                                   const InventoryManager &inv2);
+    // mergeAll: the products of inventories[0 .. count - 1], in that order.
+    // The rows are moved, not copied: the inputs are left empty.
+    // sortedByName: every input is sorted by name (invalid_argument if
+    // not); the result is then one k-way merge, sorted by name, where the
+    // duplicates (see removeDuplicates) are summed on the fly.
+    static InventoryManager mergeAll(InventoryManager *inventories[], int count,
+                                     bool sortedByName = false);
 
     void split(InventoryManager &section1,
                InventoryManager &section2,
                double ratio) const;
+    // views: O(1), no product is copied (see InventoryView)
+    InventoryView view() const;
+    void split(InventoryView &section1,
+               InventoryView &section2,
+               double ratio) const;
+    // select: a query over several predicates (see QueryBuilder)
+    QueryBuilder select() const;
 
     List2D<InventoryAttribute> getAttributesMatrix() const;
     List1D<string> getProductNames() const;
@@ -127,6 +682,228 @@ public:
     string toString() const;
 
     InventoryManager &operator=(const InventoryManager &other);
+    InventoryManager &operator=(InventoryManager &&other);
+
+private:
+    friend class InventoryView;
+    friend class QueryBuilder;
+
+    List1D<string> queryRange(const string &attributeName, double minValue, double maxValue,
+                              int minQuantity, bool ascending, int firstSlot, int lastSlot,
+                              int numThreads) const;
+    static InventoryManager mergeRows(const InventoryManager *const inventories[], int count,
+                                      bool move, bool sortedByName);
+
+    // partial result of aggregate, one per thread
+    struct Reduction
+    {
+        double sum = 0;
+        double min = INFINITY;
+        double max = -INFINITY;
+        long long count = 0;
+
+        void add(double value)
+        {
+            sum += value;
+            min = value < min ? value : min;
+            max = value > max ? value : max;
+            count += 1;
+        }
+        void add(const Reduction &other)
+        {
+            sum += other.sum;
+            min = other.min < min ? other.min : min;
+            max = other.max > max ? other.max : max;
+            count += other.count;
+        }
+        double result(AggregateOp op) const;
+    };
+    template <class Fn>
+    static void forChunks(int slots, int numThreads, Fn fn);
+    template <class Fn>
+    void forSelected(const string &attributeName, double minValue, double maxValue,
+                     int from, int to, Fn fn) const;
+
+    // head of one input in the k-way merge of mergeRows
+    class MergeCursor
+    {
+    public:
+        const string *name;
+        int source;
+        int slot;
+
+        MergeCursor() : name(nullptr), source(0), slot(0) {}
+        MergeCursor(const string *name, int source, int slot) : name(name), source(source), slot(slot) {}
+        // by name, then by input: equal names keep the order of the inputs
+        static int compare(MergeCursor &lhs, MergeCursor &rhs)
+        {
+            int order = lhs.name->compare(*rhs.name);
+            if (order != 0) {
+                return order < 0 ? -1 : 1;
+            }
+            return lhs.source < rhs.source ? -1 : (lhs.source > rhs.source ? 1 : 0);
+        }
+        bool operator<(const MergeCursor &other) const
+        {
+            return *name < *other.name || (*name == *other.name && source < other.source);
+        }
+        bool operator>(const MergeCursor &other) const
+        {
+            return other < *this;
+        }
+        friend ostream &operator<<(ostream &os, const MergeCursor &cursor)
+        {
+            os << *cursor.name << "@" << cursor.source;
+            return os;
+        }
+    };
+};
+
+// -------------------- InventoryView --------------------
+/*
+ * InventoryView: a read-only slice of an InventoryManager, without copying
+ * any product. It is either a range of rows (offset, length) or a list of
+ * row numbers, and slicing or splitting a view gives new views in O(1).
+ * A view owns nothing: the inventory (and the row array, for a list view)
+ * must outlive it, and any change to the inventory's products makes the
+ * view's row numbers stale.
+ */
+class InventoryView
+{
+private:
+    const InventoryManager *inventory;
+    const int *rowList; // nullptr: the rows offset .. offset + length - 1
+    int offset;         // into rowList for a list view
+    int length;
+
+public:
+    InventoryView();
+    InventoryView(const InventoryManager &inventory);
+    InventoryView(const InventoryManager &inventory, int offset, int length);
+    InventoryView(const InventoryManager &inventory, const int *rows, int count);
+
+    int size() const;
+    int rowOf(int index) const; // row of the inventory at position "index"
+    List1D<InventoryAttribute> getProductAttributes(int index) const;
+    string getProductName(int index) const;
+    int getProductQuantity(int index) const;
+    AttributeSpan attributesOf(int index) const;
+
+    List1D<string> query(string attributeName, const double &minValue,
+                         const double &maxValue, int minQuantity, bool ascending) const;
+
+    InventoryView slice(int offset, int length) const;
+    void split(InventoryView &section1,
+               InventoryView &section2,
+               double ratio) const;
+};
+
+// -------------------- QueryBuilder --------------------
+/*
+ * QueryBuilder: a query over several predicates, built one call at a time:
+ *      inventory.select().whereAttribute("weight", 1, 5).whereQuantity(10)
+ *               .orWhere().whereNamePrefix("Tool")
+ *               .orderByAttribute("weight", false).limit(10).names();
+ * Consecutive predicates are ANDed; orWhere() starts a new conjunction and
+ * the result is the OR of the conjunctions (each product at most once).
+ *  + whereAttribute : some occurrence of the attribute is in [min, max]
+ *  + whereNamePrefix: the name starts with the prefix
+ *  + whereQuantity  : the quantity is in [min, max]
+ *
+ * Plan, per conjunction: the indexed predicate (attribute: sorted index,
+ * name prefix: name index) with the fewest entries in range drives, so
+ * only those slots are visited (without one, every product is scanned).
+ * The other predicates are then checked late, on those candidates only,
+ * the most selective first. The selectivities are read from the indexes,
+ * or estimated from a sample of ESTIMATE_SAMPLE products for quantities;
+ * explain() prints them with the plan.
+ *
+ * Order: product order, unless orderByAttribute (value of the first
+ * occurrence; products without the attribute, or with NaN there, come
+ * last) or orderByQuantity is set, ties in product order. offset/limit cut
+ * the ordered result; with a limit, only the first offset + limit products
+ * are sorted (top-k).
+ * The builder only refers to the inventory, which must outlive it.
+ */
+class QueryBuilder
+{
+public:
+    static constexpr int ESTIMATE_SAMPLE = 128;
+
+    QueryBuilder(const InventoryManager &inventory);
+
+    QueryBuilder &whereAttribute(const string &attributeName, double minValue, double maxValue);
+    QueryBuilder &whereNamePrefix(const string &prefix);
+    QueryBuilder &whereQuantity(int minQuantity, int maxQuantity = INT_MAX);
+    QueryBuilder &orWhere();
+
+    QueryBuilder &orderByAttribute(const string &attributeName, bool ascending = true);
+    QueryBuilder &orderByQuantity(bool ascending = true);
+    QueryBuilder &offset(int count);
+    QueryBuilder &limit(int count); // -1: no limit
+
+    List1D<int> rows() const; // product indices, in result order
+    List1D<string> names() const;
+    string explain() const;
+
+private:
+    enum PredicateKind { ATTRIBUTE, NAME_PREFIX, QUANTITY };
+    enum OrderKind { NO_ORDER, BY_ATTRIBUTE, BY_QUANTITY };
+
+    struct Predicate
+    {
+        PredicateKind kind = ATTRIBUTE;
+        int conjunction = 0;
+        string text; // attribute name or prefix
+        double minValue = 0;
+        double maxValue = 0;
+
+        bool operator==(const Predicate &other) const
+        {
+            return kind == other.kind && conjunction == other.conjunction && text == other.text &&
+                   minValue == other.minValue && maxValue == other.maxValue;
+        }
+        friend ostream &operator<<(ostream &os, const Predicate &predicate)
+        {
+            os << predicate.kind << ":" << predicate.text << "[" << predicate.minValue << ", "
+               << predicate.maxValue << "]@" << predicate.conjunction;
+            return os;
+        }
+    };
+    // one predicate of a conjunction in the plan; the driver comes first
+    struct Step
+    {
+        int predicate = 0;
+        int firstColumn = -1;  // attributes: first column of the name
+        double selectivity = 0;
+        int entries = -1;      // indexed predicates: index entries in range
+
+        bool operator==(const Step &other) const
+        {
+            return predicate == other.predicate;
+        }
+        friend ostream &operator<<(ostream &os, const Step &step)
+        {
+            os << step.predicate << "(" << step.selectivity << ")";
+            return os;
+        }
+    };
+
+    const InventoryManager *inventory;
+    XArrayList<Predicate> predicates;
+    int conjunctions;
+    OrderKind orderKind;
+    string orderName;
+    bool orderAscending;
+    int skip;
+    int take;
+
+    QueryBuilder &add(const Predicate &predicate);
+    XArrayList<Step> plan(int conjunction) const;
+    void indexRange(const Predicate &predicate, int &first, int &last) const;
+    bool matches(const Step &step, int slot) const;
+    XArrayList<int> resultSlots() const;
+    string describe(const Predicate &predicate) const;
 };
 
 // -------------------- List1D Method Definitions --------------------
@@ -167,6 +944,12 @@ inline List1D<T>::List1D(const List1D<T> &other)
     }
 }
 
+template <typename T>
+inline List1D<T>::List1D(List1D<T> &&other) : List1D()
+{
+    swap(pList, other.pList);
+}
+
 template <typename T>
 inline List1D<T>::~List1D()
 {
@@ -209,6 +992,12 @@ inline void List1D<T>::add(const T &value)
     pList->add(value);
 }
 
+template <typename T>
+inline void List1D<T>::add(T &&value)
+{
+    pList->add(std::move(value));
+}
+
 template <typename T>
 inline string List1D<T>::toString() const
 {
@@ -239,6 +1028,16 @@ inline List1D<T> &List1D<T>::operator=(const List1D<T> &list)
     return *this;
 }
 
+template <typename T>
+inline List1D<T> &List1D<T>::operator=(List1D<T> &&list)
+{
+    if (this != &list) {
+        swap(pList, list.pList);
+        list.pList->clear();
+    }
+    return *this;
+}
+
 // -------------------- List2D Method Definitions --------------------
 template <typename T>
 inline List2D<T>::List2D()
@@ -283,6 +1082,12 @@ inline List2D<T>::List2D(const List2D<T> &other)
     }
 }
 
+template <typename T>
+inline List2D<T>::List2D(List2D<T> &&other) : List2D()
+{
+    swap(pMatrix, other.pMatrix);
+}
+
 template <typename T>
 inline List2D<T>::~List2D()
 {
@@ -327,6 +1132,21 @@ inline void List2D<T>::setRow(int rowIndex, const List1D<T> &row)
     }
 }
 
+template <typename T>
+inline void List2D<T>::setRow(int rowIndex, List1D<T> &&row)
+{
+    if (rowIndex < 0 || rowIndex > rows()) {
+        throw out_of_range("Index is out of range");
+    }
+    if (rowIndex < rows()) {
+        delete pMatrix->get(rowIndex);
+        pMatrix->get(rowIndex) = row.pList;
+    } else {
+        pMatrix->add(row.pList);
+    }
+    row.pList = new XArrayList<T>();
+}
+
 template <typename T>
 inline T List2D<T>::get(int rowIndex, int colIndex) const
 {
@@ -339,7 +1159,7 @@ inline List1D<T> List2D<T>::getRow(int rowIndex) const
 {
     // TODO
     IList<T>* row = pMatrix->get(rowIndex);
-    List1D<T> list;
+    List1D<T> list(row->size());
     for (int i = 0; i < row->size(); i++) {
         list.add(row->get(i));
     }
@@ -398,232 +1218,1862 @@ inline List2D<T> &List2D<T>::operator=(const List2D<T> &matrix)
     return *this;
 }
 
-// -------------------- InventoryManager Method Definitions --------------------
-inline InventoryManager::InventoryManager()
+template <typename T>
+inline List2D<T> &List2D<T>::operator=(List2D<T> &&matrix)
 {
-    // TODO
-    attributesMatrix = List2D<InventoryAttribute>();
-    productNames = List1D<string>();
-    quantities = List1D<int>();
+    if (this != &matrix) {
+        swap(pMatrix, matrix.pMatrix);
+        for (int i = 0; i < matrix.pMatrix->size(); i++) {
+            delete matrix.pMatrix->get(i);
+        }
+        matrix.pMatrix->clear();
+    }
+    return *this;
 }
 
-inline InventoryManager::InventoryManager(const List2D<InventoryAttribute> &matrix,
-                                   const List1D<string> &names,
-                                   const List1D<int> &quantities)
+// -------------------- AttributeNames Method Definitions --------------------
+inline int AttributeNames::intern(const string &name)
 {
-    // TODO
-    this->attributesMatrix = matrix;
-    this->productNames = List1D<string>();
-    this->quantities = List1D<int>();
-    
-    for(int i = 0; i < names.size(); i++) {
-        this->productNames.add(names.get(i));
+    Table &t = table();
+    lock_guard<mutex> guard(t.lock);
+    if (t.ids.containsKey(name)) {
+        return t.ids.get(name);
     }
-    
-    for(int i = 0; i < quantities.size(); i++) {
-        this->quantities.add(quantities.get(i));
+    return t.add(name);
+}
+
+inline int AttributeNames::find(const string &name)
+{
+    Table &t = table();
+    lock_guard<mutex> guard(t.lock);
+    if (t.ids.containsKey(name)) {
+        return t.ids.get(name);
     }
+    return -1;
 }
 
-inline InventoryManager::InventoryManager(const InventoryManager &other)
+inline const string &AttributeNames::nameOf(int id)
 {
-    // TODO
-    attributesMatrix = other.attributesMatrix;
-    productNames = other.productNames;
-    quantities = other.quantities;
+    Table &t = table();
+    // acquire: the slot (and its chunk) of every id below size is visible
+    if (id < 0 || id >= t.size.load(memory_order_acquire)) {
+        throw out_of_range("Index is out of range!");
+    }
+    return *t.slot(id).load(memory_order_relaxed);
 }
 
-inline int InventoryManager::size() const
+inline int AttributeNames::count()
 {
-    // TODO
-    return attributesMatrix.rows();
+    return table().size.load(memory_order_acquire);
 }
 
-inline List1D<InventoryAttribute> InventoryManager::getProductAttributes(int index) const
+// -------------------- InventoryColumns Method Definitions --------------------
+inline InventoryColumns::InventoryColumns()
+    : nameIds(nullptr), sortedNames(nullptr), bulkFrom(-1)
 {
-    // TODO
-    if (index < 0 || index >= size()) {
-        throw out_of_range("Index is invalid!");
-    }
+    rowStart.add(0);
+    deadCount = 0;
+}
 
-    return attributesMatrix.getRow(index);
+inline InventoryColumns::InventoryColumns(const InventoryColumns &other)
+    : nameIds(nullptr), sortedNames(nullptr), bulkFrom(-1)
+{
+    copyFrom(other);
 }
 
-inline string InventoryManager::getProductName(int index) const
+inline InventoryColumns &InventoryColumns::operator=(const InventoryColumns &other)
 {
-    // TODO
-    if (index < 0 || index >= size()) {
-        throw out_of_range("Index is invalid!");
+    if (this != &other) {
+        removeInternalData();
+        copyFrom(other);
     }
+    return *this;
+}
 
-    return productNames.get(index);
+inline InventoryColumns::InventoryColumns(InventoryColumns &&other)
+    : firstColumn(std::move(other.firstColumn)), columns(std::move(other.columns)),
+      names(std::move(other.names)), quantities(std::move(other.quantities)),
+      rowStart(std::move(other.rowStart)), rowColumns(std::move(other.rowColumns)),
+      live(std::move(other.live)), deadCount(other.deadCount),
+      liveTree(std::move(other.liveTree)), indexes(std::move(other.indexes)),
+      nameIds(other.nameIds), nameSlots(std::move(other.nameSlots)), sortedNames(other.sortedNames),
+      bulkFrom(-1)
+{
+    other.rowStart.add(0);
+    other.deadCount = 0;
+    other.nameIds = nullptr;
+    other.sortedNames = nullptr;
 }
 
-inline int InventoryManager::getProductQuantity(int index) const
+inline InventoryColumns &InventoryColumns::operator=(InventoryColumns &&other)
 {
-    // TODO
-    if (index < 0 || index >= size()) {
-        throw out_of_range("Index is invalid!");
+    if (this != &other) {
+        removeInternalData();
+        firstColumn = std::move(other.firstColumn);
+        columns = std::move(other.columns);
+        names = std::move(other.names);
+        quantities = std::move(other.quantities);
+        rowStart = std::move(other.rowStart);
+        rowColumns = std::move(other.rowColumns);
+        live = std::move(other.live);
+        deadCount = other.deadCount;
+        liveTree = std::move(other.liveTree);
+        indexes = std::move(other.indexes);
+        nameIds = other.nameIds;
+        nameSlots = std::move(other.nameSlots);
+        sortedNames = other.sortedNames;
+        bulkFrom = -1;
+
+        other.rowStart.add(0);
+        other.deadCount = 0;
+        other.nameIds = nullptr;
+        other.sortedNames = nullptr;
     }
+    return *this;
+}
 
-    return quantities.get(index);
+inline InventoryColumns::~InventoryColumns()
+{
+    removeInternalData();
 }
 
-inline void InventoryManager::updateQuantity(int index, int newQuantity)
+inline int InventoryColumns::rows() const
 {
-    // TODO
-    if (index < 0 || index >= size()) {
-        throw out_of_range("Index is invalid!");
-    }
+    return names.size() - deadCount;
+}
 
-    quantities.set(index, newQuantity);
+inline void InventoryColumns::addRow(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    appendRow(attributes.size(), [&](int k) { return attributes.get(k); }, name, quantity);
 }
 
-inline void InventoryManager::addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+inline void InventoryColumns::addRow(const InventoryAttribute *attributes, int count, const string &name, int quantity)
 {
-    // TODO
-    attributesMatrix.setRow(attributesMatrix.rows(), attributes);
-    productNames.add(name);
-    quantities.add(quantity);
+    appendRow(count, [&](int k) -> const InventoryAttribute & { return attributes[k]; }, name, quantity);
 }
 
-inline void InventoryManager::removeProduct(int index)
+/* appendRow: one new slot, with the attributes attribute(0 .. count - 1) */
+template <class Get>
+inline void InventoryColumns::appendRow(int count, Get attribute, const string &name, int quantity)
 {
-    // TODO
-    if (index < 0 || index >= size()) {
-        throw out_of_range("Index is invalid!");
+    int slot = names.size();
+    names.add(name);
+    quantities.add(quantity);
+    for (int c = 0; c < columns.size(); c++) {
+        columns.get(c)->values.add(0);
+        columns.get(c)->valid.add(false);
     }
-
-    List2D<InventoryAttribute> newAttributesMatrix;
-    List1D<string> newProductNames(size() - 1);
-    List1D<int> newQuantities(size() - 1);
-
-    for (int i = 0; i < size(); i++) {
-        if (i != index) { // Only add elements that are not at the specified index
-            newAttributesMatrix.setRow(newAttributesMatrix.rows(), attributesMatrix.getRow(i));
-            newProductNames.add(productNames.get(i));
-            newQuantities.add(quantities.get(i));
-        }
+    live.add(true);
+    if (deadCount > 0) {
+        addLive(slot >> 6, 1);
     }
 
-    attributesMatrix = newAttributesMatrix;
-    productNames = newProductNames;
-    quantities = newQuantities;
+    for (int k = 0; k < count; k++) {
+        const InventoryAttribute &item = attribute(k);
+        int id = columnFor(item.name.getId(), slot);
+        Column *col = columns.get(id);
+        col->values.get(slot) = item.value;
+        col->valid.set(slot, true);
+        rowColumns.add(id);
+        indexAdd(item.name.getId(), item.value, slot, id);
+    }
+    rowStart.add(rowColumns.size());
+    nameIndexAdd(slot);
 }
 
-inline List1D<string> InventoryManager::query(string attributeName, const double &minValue,
-                                       const double &maxValue, int minQuantity, bool ascending) const
+/*
+ * removeRow: O(log n) to find and mark the slot, plus the amortized cost of
+ *      the compaction that runs once the dead fraction is too high.
+ */
+inline void InventoryColumns::removeRow(int row)
 {
-    // TODO
-    List1D<double> validAttributes;
-    List1D<string> validNames;
+    markDead(slotOf(row));
+    purgeIfNeeded();
+}
 
-    for (int i = 0; i < size(); i++) {
-        if (quantities.get(i) >= minQuantity) {
-            validNames.add(productNames.get(i));
+inline void InventoryColumns::removeRows(const int *rows, int count)
+{
+    int *slots = new int[count > 0 ? count : 1];
+    try {
+        for (int i = 0; i < count; i++) {
+            slots[i] = slotOf(rows[i]);
         }
+    } catch (...) {
+        delete[] slots;
+        throw;
     }
-
-    for (int i = 0; i < size(); i++) {
-        for (int j = 0; j < attributesMatrix.getRow(i).size(); j++) {
-            if (attributesMatrix.get(i, j).name == attributeName &&
-                attributesMatrix.get(i, j).value >= minValue &&
-                attributesMatrix.get(i, j).value <= maxValue) {
-                validAttributes.add(attributesMatrix.get(i, j).value);
-                break;
-            }
+    for (int i = 0; i < count; i++) {
+        if (live.get(slots[i])) {
+            markDead(slots[i]);
         }
     }
+    delete[] slots;
+    purgeIfNeeded();
+}
 
-    for (int i = 0; i < validAttributes.size() - 1; i++) {
-        for (int j = i + 1; j < validAttributes.size(); j++) {
-            if (ascending) {
-                if (validAttributes.get(i) > validAttributes.get(j)) {
-                    double temp = validAttributes.get(i);
-                    validAttributes.set(i, validAttributes.get(j));
-                    validAttributes.set(j, temp);
-
-                    string tempName = validNames.get(i);
-                    validNames.set(i, validNames.get(j));
-                    validNames.set(j, tempName);
-                }
-            } else {
-                if (validAttributes.get(i) < validAttributes.get(j)) {
-                    double temp = validAttributes.get(i);
-                    validAttributes.set(i, validAttributes.get(j));
-                    validAttributes.set(j, temp);
-
-                    string tempName = validNames.get(i);
-                    validNames.set(i, validNames.get(j));
-                    validNames.set(j, tempName);
+inline void InventoryColumns::compact(const Bitmap &keep)
+{
+    if (keep.size() != rows()) {
+        throw invalid_argument("Size of the keep bitmap differs from the number of rows!");
+    }
+    Bitmap keepSlots(slotCount());
+    int row = 0;
+    for (int slot = live.nextSet(0); slot != -1; slot = live.nextSet(slot + 1)) {
+        if (keep.get(row++)) {
+            keepSlots.set(slot, true);
+        }
+    }
+    compactSlots(keepSlots);
+}
+
+inline void InventoryColumns::purge()
+{
+    if (deadCount > 0) {
+        compactSlots(live);
+    }
+}
+
+inline void InventoryColumns::clear()
+{
+    removeInternalData();
+    rowStart.add(0);
+}
+
+inline List1D<InventoryAttribute> InventoryColumns::getRow(int row) const
+{
+    int slot = slotOf(row);
+    int first = rowStart.get(slot);
+    int last = rowStart.get(slot + 1);
+    List1D<InventoryAttribute> list(last - first);
+    for (int k = first; k < last; k++) {
+        Column *col = columns.get(rowColumns.get(k));
+        list.add(InventoryAttribute(col->name, col->values.get(slot)));
+    }
+    return list;
+}
+
+inline const string &InventoryColumns::getName(int row) const
+{
+    return names.get(slotOf(row));
+}
+
+inline int InventoryColumns::getQuantity(int row) const
+{
+    return quantities.get(slotOf(row));
+}
+
+inline void InventoryColumns::setQuantity(int row, int quantity)
+{
+    quantities.get(slotOf(row)) = quantity;
+}
+
+inline int InventoryColumns::slotCount() const
+{
+    return names.size();
+}
+
+inline bool InventoryColumns::isLive(int slot) const
+{
+    return live.get(slot);
+}
+
+/*
+ * slotOf(row): the slot of the row-th live product. Fenwick descent to the
+ *      word holding it, then the matching set bit inside the word.
+ */
+inline int InventoryColumns::slotOf(int row) const
+{
+    if (row < 0 || row >= rows()) {
+        throw out_of_range("Index is out of range!");
+    }
+    if (deadCount == 0) {
+        return row;
+    }
+
+    int size = liveTree.size() - 1;
+    const int *tree = &liveTree.get(0);
+    int position = 0;
+    int step = 1;
+    while (step * 2 <= size) {
+        step *= 2;
+    }
+    for (; step > 0; step /= 2) {
+        if (position + step <= size && tree[position + step] <= row) {
+            position += step;
+            row -= tree[position];
+        }
+    }
+    unsigned long long bits = live.data()[position];
+    for (int i = 0; i < row; i++) {
+        bits &= bits - 1;
+    }
+    return (position << 6) + __builtin_ctzll(bits);
+}
+
+inline int InventoryColumns::rowOfSlot(int slot) const
+{
+    if (deadCount == 0) {
+        return slot;
+    }
+    int word = slot >> 6;
+    unsigned long long below = live.data()[word] & ((1ULL << (slot & 63)) - 1);
+    return liveBefore(word) + __builtin_popcountll(below);
+}
+
+inline const Bitmap &InventoryColumns::getLive() const
+{
+    return live;
+}
+
+inline const XArrayList<string> &InventoryColumns::getNames() const
+{
+    return names;
+}
+
+inline const XArrayList<int> &InventoryColumns::getQuantities() const
+{
+    return quantities;
+}
+
+inline const XArrayList<int> &InventoryColumns::getRowStarts() const
+{
+    return rowStart;
+}
+
+inline const XArrayList<int> &InventoryColumns::getRowColumns() const
+{
+    return rowColumns;
+}
+
+inline int InventoryColumns::rowSize(int row) const
+{
+    int slot = slotOf(row);
+    return rowStart.get(slot + 1) - rowStart.get(slot);
+}
+
+inline int InventoryColumns::rowColumn(int row, int k) const
+{
+    return rowColumns.get(rowStart.get(slotOf(row)) + k);
+}
+
+inline unsigned long long InventoryColumns::rowHash(int row) const
+{
+    int slot = slotOf(row);
+    unsigned long long hash = 1469598103934665603ULL; // FNV-1a, 64 bits
+    const string &name = names.get(slot);
+    for (size_t i = 0; i < name.length(); i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL;
+    }
+    for (int k = rowStart.get(slot); k < rowStart.get(slot + 1); k++) {
+        int id = rowColumns.get(k);
+        double value = columns.get(id)->values.get(slot);
+        if (value == 0) {
+            value = 0; // -0.0 == 0.0: same hash
+        }
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ (unsigned long long)id) * 1099511628211ULL;
+        hash = (hash ^ bits) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline bool InventoryColumns::sameRow(int row1, int row2) const
+{
+    int slot1 = slotOf(row1), slot2 = slotOf(row2);
+    int first1 = rowStart.get(slot1), first2 = rowStart.get(slot2);
+    int length = rowStart.get(slot1 + 1) - first1;
+    if (rowStart.get(slot2 + 1) - first2 != length || names.get(slot1) != names.get(slot2)) {
+        return false;
+    }
+    for (int k = 0; k < length; k++) {
+        int id = rowColumns.get(first1 + k);
+        if (rowColumns.get(first2 + k) != id ||
+            columns.get(id)->values.get(slot1) != columns.get(id)->values.get(slot2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int InventoryColumns::columnCount() const
+{
+    return columns.size();
+}
+
+inline int InventoryColumns::findColumn(const string &attributeName) const
+{
+    return findColumn(AttributeNames::find(attributeName));
+}
+
+inline int InventoryColumns::findColumn(int nameId) const
+{
+    if (nameId < 0 || nameId >= firstColumn.size()) {
+        return -1;
+    }
+    return firstColumn.get(nameId);
+}
+
+inline InventoryColumns::Column &InventoryColumns::column(int id) const
+{
+    return *columns.get(id);
+}
+
+/*
+ * sortedIndex(nameId): all the values of one attribute name with their
+ *      slots, sorted by (value, slot). Built in O(n log n) on the first
+ *      call, then kept up to date.
+ */
+inline const XArrayList<InventoryColumns::IndexEntry> &InventoryColumns::sortedIndex(int nameId) const
+{
+    if (nameId < 0) {
+        throw out_of_range("Attribute name id is invalid!");
+    }
+    lock_guard<mutex> guard(indexLock);
+    if (nameId >= indexes.size() || indexes.get(nameId) == nullptr) {
+        buildIndex(nameId);
+    }
+    return *indexes.get(nameId);
+}
+
+inline const XArrayList<int> *InventoryColumns::slotsNamed(const string &name) const
+{
+    xMap<string, int> *ids;
+    {
+        lock_guard<mutex> guard(indexLock);
+        if (nameIds == nullptr) {
+            buildNameSlots();
+        }
+        ids = nameIds;
+    }
+    // built: only read from here on, as long as the products do not change
+    if (!ids->containsKey(name)) {
+        return nullptr;
+    }
+    return nameSlots.get(ids->get(name));
+}
+
+inline const XArrayList<int> &InventoryColumns::slotsByName() const
+{
+    lock_guard<mutex> guard(indexLock);
+    if (sortedNames == nullptr) {
+        buildSortedNames();
+    }
+    return *sortedNames;
+}
+
+inline void InventoryColumns::prefixRange(const string &prefix, int &first, int &last) const
+{
+    const XArrayList<int> &order = slotsByName();
+    first = last = 0;
+    if (order.size() == 0) {
+        return;
+    }
+    const int *slots = &order.get(0);
+    const string *nameArray = &names.get(0);
+    first = lower_bound(slots, slots + order.size(), prefix,
+                        [nameArray](int slot, const string &value) {
+                            return nameArray[slot] < value;
+                        }) - slots;
+    // the names starting with prefix are followed by the ones whose first
+    // prefix.length() characters compare greater
+    last = upper_bound(slots + first, slots + order.size(), prefix,
+                       [nameArray](const string &value, int slot) {
+                           return nameArray[slot].compare(0, value.length(), value) > 0;
+                       }) - slots;
+}
+
+inline void InventoryColumns::reserve(int slots, int cells)
+{
+    names.reserve(slots);
+    quantities.reserve(slots);
+    rowStart.reserve(slots + 1);
+    rowColumns.reserve(cells);
+    live.reserve(slots);
+    for (int c = 0; c < columns.size(); c++) {
+        columns.get(c)->values.reserve(slots);
+        columns.get(c)->valid.reserve(slots);
+    }
+}
+
+inline int InventoryColumns::cellCount() const
+{
+    return rowColumns.size();
+}
+
+/*
+ * mapColumns(source): the k-th column of a name in "source" goes to the
+ *      k-th column of that name here, so the rows keep their repeated
+ *      attributes in the same order. The caller deletes the array.
+ */
+inline int *InventoryColumns::mapColumns(const InventoryColumns &source)
+{
+    int *columnMap = new int[source.columns.size() + 1];
+    for (int nameId = 0; nameId < source.firstColumn.size(); nameId++) {
+        int id = findColumn(nameId);
+        int previous = -1;
+        for (int c = source.firstColumn.get(nameId); c != -1; c = source.columns.get(c)->next) {
+            if (id == -1) {
+                id = columns.size();
+                columns.add(new Column(AttributeName::fromId(nameId), slotCount()));
+                if (previous == -1) {
+                    while (firstColumn.size() <= nameId) {
+                        firstColumn.add(-1);
+                    }
+                    firstColumn.get(nameId) = id;
+                } else {
+                    columns.get(previous)->next = id;
+                }
+            }
+            columnMap[c] = id;
+            previous = id;
+            id = columns.get(id)->next;
+        }
+    }
+    return columnMap;
+}
+
+/*
+ * appendSlot: O(columns + attributes of the slot), like addRow, but the
+ *      values are read straight from the source arrays and no name is
+ *      interned again.
+ */
+inline void InventoryColumns::appendSlot(InventoryColumns &source, int slot, const int *columnMap, bool move)
+{
+    int newSlot = names.size();
+    if (move) {
+        names.add(std::move(source.names.get(slot)));
+    } else {
+        names.add(source.names.get(slot));
+    }
+    quantities.add(source.quantities.get(slot));
+    for (int c = 0; c < columns.size(); c++) {
+        columns.get(c)->values.add(0);
+        columns.get(c)->valid.add(false);
+    }
+    live.add(true);
+    if (deadCount > 0) {
+        addLive(newSlot >> 6, 1);
+    }
+
+    for (int k = source.rowStart.get(slot); k < source.rowStart.get(slot + 1); k++) {
+        Column *from = source.columns.get(source.rowColumns.get(k));
+        int id = columnMap[source.rowColumns.get(k)];
+        double value = from->values.get(slot);
+        Column *col = columns.get(id);
+        col->values.get(newSlot) = value;
+        col->valid.set(newSlot, true);
+        rowColumns.add(id);
+        indexAdd(from->name.getId(), value, newSlot, id);
+    }
+    rowStart.add(rowColumns.size());
+    nameIndexAdd(newSlot);
+}
+
+/*
+ * sameSlot: sameRow across two storages (column ids differ between them,
+ *      so the attributes are compared by name id).
+ */
+inline bool InventoryColumns::sameSlot(int slot, const InventoryColumns &other, int otherSlot) const
+{
+    int first = rowStart.get(slot), otherFirst = other.rowStart.get(otherSlot);
+    int length = rowStart.get(slot + 1) - first;
+    if (other.rowStart.get(otherSlot + 1) - otherFirst != length || names.get(slot) != other.names.get(otherSlot)) {
+        return false;
+    }
+    for (int k = 0; k < length; k++) {
+        Column *col = columns.get(rowColumns.get(first + k));
+        Column *otherCol = other.columns.get(other.rowColumns.get(otherFirst + k));
+        if (col->name != otherCol->name || col->values.get(slot) != otherCol->values.get(otherSlot)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void InventoryColumns::beginBulk()
+{
+    bulkFrom = slotCount();
+}
+
+/*
+ * endBulk: in each built index, the entries of the slots >= bulkFrom are
+ *      the tail: sort it, then merge it with the sorted head (O(n) + the
+ *      sort of the new entries, instead of one insertion per entry).
+ */
+inline void InventoryColumns::endBulk()
+{
+    if (bulkFrom == -1) {
+        return;
+    }
+    for (int nameId = 0; nameId < indexes.size(); nameId++) {
+        XArrayList<IndexEntry> *index = indexes.get(nameId);
+        if (index == nullptr || index->size() == 0) {
+            continue;
+        }
+        IndexEntry *entries = &index->get(0);
+        int n = index->size();
+        int tail = n;
+        while (tail > 0 && entries[tail - 1].slot >= bulkFrom) {
+            tail--;
+        }
+        sort(entries + tail, entries + n);
+        inplace_merge(entries, entries + tail, entries + n);
+    }
+    if (sortedNames != nullptr && sortedNames->size() > 0) {
+        int *slots = &sortedNames->get(0);
+        int n = sortedNames->size();
+        int tail = n;
+        while (tail > 0 && slots[tail - 1] >= bulkFrom) {
+            tail--;
+        }
+        const string *nameArray = &names.get(0);
+        auto before = [nameArray](int lhs, int rhs) {
+            int order = nameArray[lhs].compare(nameArray[rhs]);
+            return order < 0 || (order == 0 && lhs < rhs);
+        };
+        sort(slots + tail, slots + n, before);
+        inplace_merge(slots, slots + tail, slots + n, before);
+    }
+    bulkFrom = -1;
+}
+
+/*
+ * columnFor(nameId, slot): the first column of that name where "slot" has
+ *      no value yet; a new column is appended to the chain if needed.
+ */
+inline int InventoryColumns::columnFor(int nameId, int slot)
+{
+    int id = findColumn(nameId);
+    int previous = -1;
+    while (id != -1 && columns.get(id)->valid.get(slot)) {
+        previous = id;
+        id = columns.get(id)->next;
+    }
+    if (id != -1) {
+        return id;
+    }
+
+    id = columns.size();
+    columns.add(new Column(AttributeName::fromId(nameId), slotCount()));
+    if (previous == -1) {
+        while (firstColumn.size() <= nameId) {
+            firstColumn.add(-1);
+        }
+        firstColumn.get(nameId) = id;
+    } else {
+        columns.get(previous)->next = id;
+    }
+    return id;
+}
+
+/*
+ * indexAdd: keep a built index sorted. The new slot is the last one, so
+ *      its entry goes after every entry with a value <= its own.
+ */
+inline void InventoryColumns::indexAdd(int nameId, double value, int slot, int id)
+{
+    if (nameId >= indexes.size() || indexes.get(nameId) == nullptr || std::isnan(value)) {
+        return;
+    }
+    XArrayList<IndexEntry> *index = indexes.get(nameId);
+    IndexEntry entry(value, slot, id);
+    int position = index->size();
+    if (position > 0 && bulkFrom == -1) {
+        IndexEntry *entries = &index->get(0);
+        position = upper_bound(entries, entries + index->size(), entry) - entries;
+    }
+    index->add(position, entry);
+}
+
+/* nameIndexAdd: a new slot, the greatest: last of its name in both */
+inline void InventoryColumns::nameIndexAdd(int slot)
+{
+    const string &name = names.get(slot);
+    if (nameIds != nullptr) {
+        addNameSlot(name, slot);
+    }
+    if (sortedNames != nullptr) {
+        int position = sortedNames->size();
+        if (position > 0 && bulkFrom == -1 && name < names.get(sortedNames->get(position - 1))) {
+            const int *slots = &sortedNames->get(0);
+            const string *nameArray = &names.get(0);
+            position = upper_bound(slots, slots + position, name,
+                                   [nameArray](const string &value, int other) {
+                                       return value < nameArray[other];
+                                   }) - slots;
+        }
+        sortedNames->add(position, slot);
+    }
+}
+
+inline void InventoryColumns::markDead(int slot)
+{
+    live.set(slot, false);
+    deadCount += 1;
+    if (deadCount == 1) {
+        buildLiveTree();
+    } else {
+        addLive(slot >> 6, -1);
+    }
+}
+
+inline void InventoryColumns::purgeIfNeeded()
+{
+    if (deadCount > MAX_DEAD_FRACTION * slotCount()) {
+        purge();
+    }
+}
+
+/*
+ * compactSlots(keepSlots): drop every slot s with !keepSlots.get(s) in one
+ *      pass over each array, O(slots * columns + cells). Afterwards there
+ *      is no dead slot and row == slot again.
+ */
+inline void InventoryColumns::compactSlots(const Bitmap &keepSlots)
+{
+    int n = slotCount();
+    if (n == 0) {
+        return;
+    }
+
+    int *newSlot = new int[n]; // old slot -> new slot, -1: removed
+    int kept = 0;
+    for (int s = 0; s < n; s++) {
+        newSlot[s] = keepSlots.get(s) ? kept++ : -1;
+    }
+
+    if (kept < n) {
+        string *nameArray = &names.get(0);
+        int *quantityArray = &quantities.get(0);
+        for (int s = 0; s < n; s++) {
+            if (newSlot[s] != -1 && newSlot[s] != s) {
+                nameArray[newSlot[s]] = std::move(nameArray[s]);
+                quantityArray[newSlot[s]] = quantityArray[s];
+            }
+        }
+        for (int c = 0; c < columns.size(); c++) {
+            Column *col = columns.get(c);
+            double *values = &col->values.get(0);
+            Bitmap valid(kept);
+            for (int s = 0; s < n; s++) {
+                if (newSlot[s] != -1) {
+                    values[newSlot[s]] = values[s];
+                    if (col->valid.get(s)) {
+                        valid.set(newSlot[s], true);
+                    }
+                }
+            }
+            col->valid = valid;
+            while (col->values.size() > kept) {
+                col->values.removeAt(col->values.size() - 1);
+            }
+        }
+
+        // column ids and offsets
+        int *ids = rowColumns.size() > 0 ? &rowColumns.get(0) : nullptr;
+        int *starts = &rowStart.get(0);
+        int cells = 0;
+        for (int s = 0; s < n; s++) {
+            int first = starts[s], last = starts[s + 1];
+            if (newSlot[s] == -1) {
+                continue;
+            }
+            starts[newSlot[s]] = cells;
+            for (int k = first; k < last; k++) {
+                ids[cells++] = ids[k];
+            }
+        }
+        starts[kept] = cells;
+
+        while (names.size() > kept) {
+            names.removeAt(names.size() - 1);
+            quantities.removeAt(quantities.size() - 1);
+        }
+        while (rowStart.size() > kept + 1) {
+            rowStart.removeAt(rowStart.size() - 1);
+        }
+        while (rowColumns.size() > cells) {
+            rowColumns.removeAt(rowColumns.size() - 1);
+        }
+
+        // built indexes stay sorted: (value, slot) order is kept by renumbering
+        for (int nameId = 0; nameId < indexes.size(); nameId++) {
+            XArrayList<IndexEntry> *index = indexes.get(nameId);
+            if (index == nullptr || index->size() == 0) {
+                continue;
+            }
+            IndexEntry *entries = &index->get(0);
+            int size = 0;
+            for (int i = 0; i < index->size(); i++) {
+                if (newSlot[entries[i].slot] != -1) {
+                    entries[size] = entries[i];
+                    entries[size].slot = newSlot[entries[i].slot];
+                    size++;
+                }
+            }
+            while (index->size() > size) {
+                index->removeAt(index->size() - 1);
+            }
+        }
+        for (int i = 0; i < nameSlots.size(); i++) {
+            renumberSlots(*nameSlots.get(i), newSlot);
+        }
+        if (sortedNames != nullptr) {
+            renumberSlots(*sortedNames, newSlot);
+        }
+    }
+    delete[] newSlot;
+
+    live = Bitmap(kept, true);
+    deadCount = 0;
+    liveTree.clear();
+}
+
+/*
+ * buildLiveTree: liveTree[w + 1] covers the live counts of a range of
+ *      words ending at word w (Fenwick tree); liveTree[0] is unused.
+ */
+inline void InventoryColumns::buildLiveTree()
+{
+    int words = live.wordCount();
+    liveTree = XArrayList<int>(0, 0, words + 2);
+    liveTree.add(0);
+    for (int w = 0; w < words; w++) {
+        liveTree.add(__builtin_popcountll(live.data()[w]));
+    }
+    int *tree = &liveTree.get(0);
+    for (int i = 1; i <= words; i++) {
+        int parent = i + (i & -i);
+        if (parent <= words) {
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+/* renumberSlots: drop the removed slots (-1) of a slot list, renumber the others */
+inline void InventoryColumns::renumberSlots(XArrayList<int> &slots, const int *newSlot)
+{
+    if (slots.size() == 0) {
+        return;
+    }
+    int *items = &slots.get(0);
+    int size = 0;
+    for (int i = 0; i < slots.size(); i++) {
+        if (newSlot[items[i]] != -1) {
+            items[size++] = newSlot[items[i]];
+        }
+    }
+    while (slots.size() > size) {
+        slots.removeAt(slots.size() - 1);
+    }
+}
+
+/*
+ * addLive(word, delta): the live count of "word" changed by delta; a word
+ *      just past the last one is appended to the tree.
+ */
+inline void InventoryColumns::addLive(int word, int delta)
+{
+    int i = word + 1;
+    if (i == liveTree.size()) {
+        // new node i covers words (i - lowbit(i), i]: its own count plus
+        // the live counts of the words before it in that range
+        int value = delta + liveBefore(i - 1) - liveBefore(i - (i & -i));
+        liveTree.add(value);
+        return;
+    }
+    int size = liveTree.size() - 1;
+    int *tree = &liveTree.get(0);
+    for (; i <= size; i += i & -i) {
+        tree[i] += delta;
+    }
+}
+
+/*
+ * liveBefore(word): number of live slots in the words before "word".
+ */
+inline int InventoryColumns::liveBefore(int word) const
+{
+    int total = 0;
+    for (int i = word; i > 0; i -= i & -i) {
+        total += liveTree.get(i);
+    }
+    return total;
+}
+
+inline void InventoryColumns::buildIndex(int nameId) const
+{
+    while (indexes.size() <= nameId) {
+        indexes.add(nullptr);
+    }
+
+    int total = 0;
+    for (int id = findColumn(nameId); id != -1; id = columns.get(id)->next) {
+        total += columns.get(id)->valid.countOnes();
+    }
+    XArrayList<IndexEntry> *index = new XArrayList<IndexEntry>(0, 0, total + 1);
+    for (int id = findColumn(nameId); id != -1; id = columns.get(id)->next) {
+        const Column *col = columns.get(id);
+        for (int s = col->valid.nextSet(0); s != -1; s = col->valid.nextSet(s + 1)) {
+            if (!std::isnan(col->values.get(s))) {
+                index->add(IndexEntry(col->values.get(s), s, id));
+            }
+        }
+    }
+    if (index->size() > 0) {
+        IndexEntry *entries = &index->get(0);
+        sort(entries, entries + index->size());
+    }
+    indexes.get(nameId) = index;
+}
+
+inline void InventoryColumns::buildNameSlots() const
+{
+    nameIds = new xMap<string, int>(&AttributeNames::hashName);
+    for (int s = 0; s < names.size(); s++) {
+        addNameSlot(names.get(s), s);
+    }
+}
+
+inline void InventoryColumns::addNameSlot(const string &name, int slot) const
+{
+    if (nameIds->containsKey(name)) {
+        nameSlots.get(nameIds->get(name))->add(slot);
+        return;
+    }
+    nameIds->put(name, nameSlots.size());
+    nameSlots.add(new XArrayList<int>());
+    nameSlots.get(nameSlots.size() - 1)->add(slot);
+}
+
+inline void InventoryColumns::buildSortedNames() const
+{
+    int n = names.size();
+    sortedNames = new XArrayList<int>(0, 0, n + 1);
+    for (int s = 0; s < n; s++) {
+        sortedNames->add(s);
+    }
+    if (n > 0) {
+        int *slots = &sortedNames->get(0);
+        const string *nameArray = &names.get(0);
+        sort(slots, slots + n, [nameArray](int lhs, int rhs) {
+            int order = nameArray[lhs].compare(nameArray[rhs]);
+            return order < 0 || (order == 0 && lhs < rhs);
+        });
+    }
+}
+
+inline void InventoryColumns::dropIndexes()
+{
+    for (int i = 0; i < indexes.size(); i++) {
+        delete indexes.get(i);
+    }
+    indexes.clear();
+    delete nameIds;
+    nameIds = nullptr;
+    for (int i = 0; i < nameSlots.size(); i++) {
+        delete nameSlots.get(i);
+    }
+    nameSlots.clear();
+    delete sortedNames;
+    sortedNames = nullptr;
+}
+
+inline void InventoryColumns::copyFrom(const InventoryColumns &other)
+{
+    for (int c = 0; c < other.columns.size(); c++) {
+        columns.add(new Column(*other.columns.get(c)));
+    }
+    firstColumn = other.firstColumn;
+    names = other.names;
+    quantities = other.quantities;
+    rowStart = other.rowStart;
+    rowColumns = other.rowColumns;
+    live = other.live;
+    deadCount = other.deadCount;
+    liveTree = other.liveTree;
+}
+
+inline void InventoryColumns::removeInternalData()
+{
+    for (int c = 0; c < columns.size(); c++) {
+        delete columns.get(c);
+    }
+    columns.clear();
+    names.clear();
+    quantities.clear();
+    rowStart.clear();
+    rowColumns.clear();
+    firstColumn.clear();
+    live = Bitmap();
+    deadCount = 0;
+    liveTree.clear();
+    dropIndexes();
+}
+
+// -------------------- AttributeSpan / NameView Method Definitions --------------------
+inline AttributeSpan::AttributeSpan(const InventoryColumns &store, int row)
+    : store(&store), slot(store.slotOf(row)), columnIds(nullptr), length(store.rowSize(row))
+{
+    if (length > 0) {
+        columnIds = &store.getRowColumns().get(store.getRowStarts().get(slot));
+    }
+}
+
+inline InventoryAttribute AttributeSpan::get(int k) const
+{
+    return InventoryAttribute(nameAt(k), valueAt(k));
+}
+
+inline const AttributeName &AttributeSpan::nameAt(int k) const
+{
+    if (k < 0 || k >= length) {
+        throw out_of_range("Index is out of range!");
+    }
+    return store->column(columnIds[k]).name;
+}
+
+inline double AttributeSpan::valueAt(int k) const
+{
+    if (k < 0 || k >= length) {
+        throw out_of_range("Index is out of range!");
+    }
+    return store->column(columnIds[k]).values.get(slot);
+}
+
+inline List1D<InventoryAttribute> AttributeSpan::toList() const
+{
+    List1D<InventoryAttribute> list(length);
+    for (int k = 0; k < length; k++) {
+        list.add(get(k));
+    }
+    return list;
+}
+
+inline int NameView::size() const
+{
+    return store->rows();
+}
+
+inline const string &NameView::get(int row) const
+{
+    return store->getName(row);
+}
+
+// -------------------- InventoryBatch Method Definitions --------------------
+inline InventoryBatch::InventoryBatch()
+{
+    attributeStart.add(0);
+}
+
+inline void InventoryBatch::add(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    for (int k = 0; k < attributes.size(); k++) {
+        this->attributes.add(attributes.get(k));
+    }
+    attributeStart.add(this->attributes.size());
+    names.add(name);
+    quantities.add(quantity);
+}
+
+inline void InventoryBatch::update(int index, int newQuantity)
+{
+    updateIndices.add(index);
+    updateQuantities.add(newQuantity);
+}
+
+inline void InventoryBatch::remove(int index)
+{
+    removeIndices.add(index);
+}
+
+inline int InventoryBatch::size() const
+{
+    return names.size() + updateIndices.size() + removeIndices.size();
+}
+
+inline int InventoryBatch::additions() const
+{
+    return names.size();
+}
+
+inline void InventoryBatch::clear()
+{
+    attributes.clear();
+    attributeStart.clear();
+    attributeStart.add(0);
+    names.clear();
+    quantities.clear();
+    updateIndices.clear();
+    updateQuantities.clear();
+    removeIndices.clear();
+}
+
+// -------------------- InventoryManager Method Definitions --------------------
+inline InventoryManager::InventoryManager()
+{
+}
+
+inline InventoryManager::InventoryManager(const List2D<InventoryAttribute> &matrix,
+                                   const List1D<string> &names,
+                                   const List1D<int> &quantities)
+{
+    if (names.size() != matrix.rows() || quantities.size() != matrix.rows()) {
+        throw invalid_argument("Sizes of the attributes matrix, names and quantities differ!");
+    }
+
+    for (int i = 0; i < matrix.rows(); i++) {
+        store.addRow(matrix.getRow(i), names.get(i), quantities.get(i));
+    }
+}
+
+inline InventoryManager::InventoryManager(const InventoryManager &other)
+    : store(other.store)
+{
+}
+
+inline InventoryManager::InventoryManager(InventoryManager &&other)
+    : store(std::move(other.store))
+{
+}
+
+inline int InventoryManager::size() const
+{
+    return store.rows();
+}
+
+inline List1D<InventoryAttribute> InventoryManager::getProductAttributes(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+
+    return store.getRow(index);
+}
+
+inline string InventoryManager::getProductName(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+
+    return store.getName(index);
+}
+
+inline int InventoryManager::getProductQuantity(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+
+    return store.getQuantity(index);
+}
+
+inline AttributeSpan InventoryManager::attributesOf(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+    return AttributeSpan(store, index);
+}
+
+inline NameView InventoryManager::names() const
+{
+    return NameView(store);
+}
+
+inline List1D<int> InventoryManager::findByName(const string &name) const
+{
+    const XArrayList<int> *slots = store.slotsNamed(name);
+    if (slots == nullptr) {
+        return List1D<int>();
+    }
+    List1D<int> indices(slots->size());
+    for (int i = 0; i < slots->size(); i++) {
+        if (store.isLive(slots->get(i))) {
+            indices.add(store.rowOfSlot(slots->get(i)));
+        }
+    }
+    return indices;
+}
+
+inline List1D<int> InventoryManager::findByPrefix(const string &prefix) const
+{
+    int first, last;
+    store.prefixRange(prefix, first, last);
+    const XArrayList<int> &slots = store.slotsByName();
+    List1D<int> indices(last - first);
+    for (int i = first; i < last; i++) {
+        if (store.isLive(slots.get(i))) {
+            indices.add(store.rowOfSlot(slots.get(i)));
+        }
+    }
+    return indices;
+}
+
+inline void InventoryManager::updateQuantity(int index, int newQuantity)
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+
+    store.setQuantity(index, newQuantity);
+}
+
+inline void InventoryManager::addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    store.addRow(attributes, name, quantity);
+}
+
+/*
+ * removeProduct: the product is marked dead (O(log n)); the storage is
+ *      compacted once dead products pass InventoryColumns::MAX_DEAD_FRACTION.
+ */
+inline void InventoryManager::removeProduct(int index)
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+
+    store.removeRow(index);
+}
+
+/*
+ * removeProducts(indices): remove several products at once; indices refer
+ *      to the products before the call (any order, repeats ignored).
+ *      Nothing is removed if an index is invalid. At most one compaction.
+ */
+inline void InventoryManager::removeProducts(const List1D<int> &indices)
+{
+    int count = indices.size();
+    int *rows = new int[count > 0 ? count : 1];
+    for (int i = 0; i < count; i++) {
+        rows[i] = indices.get(i);
+        if (rows[i] < 0 || rows[i] >= size()) {
+            delete[] rows;
+            throw out_of_range("Index is invalid!");
+        }
+    }
+    store.removeRows(rows, count);
+    delete[] rows;
+}
+
+/*
+ * query: names of the products with quantity >= minQuantity and a value of
+ *      attributeName in [minValue, maxValue], sorted by that value (ties in
+ *      product order). When a product repeats the attribute, its first
+ *      occurrence in range is used.
+ *      The sorted index of attributeName (built on the first query) gives
+ *      the range in O(log n), already in order: O(log n + k) in total.
+ */
+inline List1D<string> InventoryManager::query(string attributeName, const double &minValue,
+                                       const double &maxValue, int minQuantity, bool ascending) const
+{
+    return queryRange(attributeName, minValue, maxValue, minQuantity, ascending, 0, store.slotCount(), 1);
+}
+
+inline List1D<string> InventoryManager::queryParallel(string attributeName, const double &minValue,
+                                               const double &maxValue, int minQuantity, bool ascending,
+                                               int numThreads) const
+{
+    if (numThreads <= 0) {
+        numThreads = thread::hardware_concurrency();
+    }
+    return queryRange(attributeName, minValue, maxValue, minQuantity, ascending, 0, store.slotCount(),
+                      numThreads <= 0 ? 1 : numThreads);
+}
+
+/*
+ * applyBatch: the updates first, on the rows before the batch; then the
+ *      additions, appended (which keeps those row numbers) in one bulk
+ *      append; then the removals, tombstones with at most one compaction.
+ */
+inline void InventoryManager::applyBatch(const InventoryBatch &batch)
+{
+    int n = size();
+    for (int i = 0; i < batch.updateIndices.size(); i++) {
+        if (batch.updateIndices.get(i) < 0 || batch.updateIndices.get(i) >= n) {
+            throw out_of_range("Index is invalid!");
+        }
+    }
+    for (int i = 0; i < batch.removeIndices.size(); i++) {
+        if (batch.removeIndices.get(i) < 0 || batch.removeIndices.get(i) >= n) {
+            throw out_of_range("Index is invalid!");
+        }
+    }
+
+    for (int i = 0; i < batch.updateIndices.size(); i++) {
+        store.setQuantity(batch.updateIndices.get(i), batch.updateQuantities.get(i));
+    }
+
+    int additions = batch.additions();
+    if (additions > 0) {
+        store.reserve(store.slotCount() + additions, store.cellCount() + batch.attributes.size());
+        const InventoryAttribute *attributes = batch.attributes.size() > 0 ? &batch.attributes.get(0) : nullptr;
+        store.beginBulk();
+        for (int i = 0; i < additions; i++) {
+            int first = batch.attributeStart.get(i);
+            store.addRow(attributes + first, batch.attributeStart.get(i + 1) - first,
+                         batch.names.get(i), batch.quantities.get(i));
+        }
+        store.endBulk();
+    }
+
+    if (batch.removeIndices.size() > 0) {
+        store.removeRows(&batch.removeIndices.get(0), batch.removeIndices.size());
+    }
+}
+
+/*
+ * queryRange: query over the slots firstSlot .. lastSlot - 1 only.
+ *      The candidates entries[first .. last) are filtered into "accepted"
+ *      (their positions, in index order). With numThreads > 1, thread t
+ *      filters the t-th contiguous chunk into the same place of
+ *      "accepted"; the sorted partial results are then packed in chunk
+ *      order, which keeps the index order without any comparison.
+ *      Dense query (a large part of the slots in the value range): the
+ *      filters of every slot are first computed as bitmaps by vectorized
+ *      scans of the quantities and of the columns of the name
+ *      (RangeFilter), so each candidate costs two bit tests instead of
+ *      reads scattered over the arrays.
+ */
+inline List1D<string> InventoryManager::queryRange(const string &attributeName, double minValue, double maxValue,
+                                            int minQuantity, bool ascending, int firstSlot, int lastSlot,
+                                            int numThreads) const
+{
+    List1D<string> validNames;
+    int nameId = AttributeNames::find(attributeName); // never interns a new name
+    int firstColumn = store.findColumn(nameId);
+    if (firstColumn == -1 || !(minValue <= maxValue)) {
+        return validNames;
+    }
+
+    const XArrayList<InventoryColumns::IndexEntry> &index = store.sortedIndex(nameId);
+    if (index.size() == 0) {
+        return validNames;
+    }
+    const InventoryColumns::IndexEntry *entries = &index.get(0);
+    const InventoryColumns::IndexEntry *end = entries + index.size();
+    int first = lower_bound(entries, end, minValue,
+                            [](const InventoryColumns::IndexEntry &entry, double value) {
+                                return entry.value < value;
+                            }) - entries;
+    int last = upper_bound(entries, end, maxValue,
+                           [](double value, const InventoryColumns::IndexEntry &entry) {
+                               return value < entry.value;
+                           }) - entries;
+
+    int candidates = last - first;
+    if (candidates <= 0) {
+        return validNames;
+    }
+    if (candidates < PARALLEL_QUERY_MIN || numThreads < 1) {
+        numThreads = 1;
+    }
+
+    const XArrayList<string> &names = store.getNames();
+    const int *quantityArray = &store.getQuantities().get(0);
+    bool chained = store.column(firstColumn).next != -1;
+
+    int n = store.slotCount();
+    bool dense = (long long)candidates * DENSE_QUERY_RATIO >= n;
+    Bitmap rowOk;               // quantity, liveness and slot range
+    Bitmap *blocked = nullptr;  // blocked[k]: a column before the k-th of the name is in range
+    int *chainPosition = nullptr; // column id -> k
+    if (dense) {
+        rowOk = Bitmap(n);
+        unsigned long long *ok = rowOk.data();
+        const unsigned long long *liveWords = store.getLive().data();
+        RangeFilter::selectAtLeast(quantityArray, n, minQuantity, ok);
+        for (int w = 0; w < rowOk.wordCount(); w++) {
+            int base = w << 6;
+            ok[w] &= liveWords[w];
+            if (base + 64 <= firstSlot || base >= lastSlot) {
+                ok[w] = 0;
+                continue;
+            }
+            if (base < firstSlot) {
+                ok[w] &= ~0ULL << (firstSlot - base);
+            }
+            if (base + 64 > lastSlot) {
+                ok[w] &= (1ULL << (lastSlot - base)) - 1;
+            }
+        }
+
+        if (chained) {
+            int chainLength = 0;
+            for (int id = firstColumn; id != -1; id = store.column(id).next) {
+                chainLength++;
+            }
+            blocked = new Bitmap[chainLength];
+            chainPosition = new int[store.columnCount()];
+            Bitmap earlier(n), inRange(n);
+            int k = 0;
+            for (int id = firstColumn; id != -1; id = store.column(id).next, k++) {
+                const InventoryColumns::Column &col = store.column(id);
+                chainPosition[id] = k;
+                blocked[k] = earlier;
+                RangeFilter::selectRange(&col.values.get(0), n, minValue, maxValue, inRange.data());
+                const unsigned long long *valid = col.valid.data();
+                for (int w = 0; w < inRange.wordCount(); w++) {
+                    earlier.data()[w] |= inRange.data()[w] & valid[w];
+                }
+            }
+        }
+    }
+    const unsigned long long *okWords = rowOk.data();
+
+    // every filter but the value range (reads only: safe from many threads)
+    auto accepts = [&](const InventoryColumns::IndexEntry &entry) -> bool {
+        if (dense) {
+            int slot = entry.slot;
+            if (((okWords[slot >> 6] >> (slot & 63)) & 1) == 0) {
+                return false;
+            }
+            return !chained ||
+                   ((blocked[chainPosition[entry.column]].data()[slot >> 6] >> (slot & 63)) & 1) == 0;
+        }
+        if (entry.slot < firstSlot || entry.slot >= lastSlot ||
+            quantityArray[entry.slot] < minQuantity || !store.isLive(entry.slot)) {
+            return false;
+        }
+        if (chained) {
+            // reject it if an earlier occurrence of the row is in range too
+            for (int id = firstColumn; id != entry.column; id = store.column(id).next) {
+                const InventoryColumns::Column &col = store.column(id);
+                double value = col.values.get(entry.slot);
+                if (col.valid.get(entry.slot) && value >= minValue && value <= maxValue) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    int *accepted = new int[candidates];
+    int count = 0;
+    if (numThreads == 1) {
+        for (int i = first; i < last; i++) {
+            if (accepts(entries[i])) {
+                accepted[count++] = i;
+            }
+        }
+    } else {
+        int *chunkCount = new int[numThreads];
+        auto chunkStart = [&](int t) {
+            return first + (int)((long long)candidates * t / numThreads);
+        };
+        auto filterChunk = [&](int t) {
+            int *out = accepted + (chunkStart(t) - first);
+            int n = 0;
+            for (int i = chunkStart(t); i < chunkStart(t + 1); i++) {
+                if (accepts(entries[i])) {
+                    out[n++] = i;
+                }
+            }
+            chunkCount[t] = n;
+        };
+
+        thread *workers = new thread[numThreads - 1];
+        for (int t = 1; t < numThreads; t++) {
+            workers[t - 1] = thread(filterChunk, t);
+        }
+        filterChunk(0);
+        for (int t = 1; t < numThreads; t++) {
+            workers[t - 1].join();
+        }
+        delete[] workers;
+
+        for (int t = 0; t < numThreads; t++) {
+            memmove(accepted + count, accepted + (chunkStart(t) - first), chunkCount[t] * sizeof(int));
+            count += chunkCount[t];
+        }
+        delete[] chunkCount;
+    }
+    delete[] blocked;
+    delete[] chainPosition;
+
+    validNames = List1D<string>(count);
+    if (ascending) {
+        for (int i = 0; i < count; i++) {
+            validNames.add(names.get(entries[accepted[i]].slot));
+        }
+    } else {
+        // descending values, but equal values still in product order
+        int to = count;
+        while (to > 0) {
+            int from = to - 1;
+            while (from > 0 && entries[accepted[from - 1]].value == entries[accepted[to - 1]].value) {
+                from--;
+            }
+            for (int i = from; i < to; i++) {
+                validNames.add(names.get(entries[accepted[i]].slot));
+            }
+            to = from;
+        }
+    }
+    delete[] accepted;
+    return validNames;
+}
+
+/*
+ * aggregate: each thread reduces a chunk of slots (a multiple of 64, so
+ *      the chunks never share a word of the bitmaps), then the partial
+ *      results are added up in chunk order.
+ */
+inline double InventoryManager::aggregate(const string &attributeName, AggregateOp op,
+                                   double minValue, double maxValue, int numThreads) const
+{
+    int slots = store.slotCount();
+    if (numThreads <= 0) {
+        numThreads = thread::hardware_concurrency();
+    }
+    Reduction *partial = new Reduction[numThreads > 0 ? numThreads : 1];
+    forChunks(slots, numThreads, [&](int t, int from, int to) {
+        forSelected(attributeName, minValue, maxValue, from, to, [&](int, double value) {
+            partial[t].add(value);
+        });
+    });
+
+    Reduction total;
+    for (int t = 0; t < (numThreads > 0 ? numThreads : 1); t++) {
+        total.add(partial[t]);
+    }
+    delete[] partial;
+    return total.result(op);
+}
+
+inline double InventoryManager::aggregateQuantity(AggregateOp op, int numThreads) const
+{
+    int slots = store.slotCount();
+    if (numThreads <= 0) {
+        numThreads = thread::hardware_concurrency();
+    }
+    Reduction *partial = new Reduction[numThreads > 0 ? numThreads : 1];
+    const unsigned long long *live = store.getLive().data();
+    forChunks(slots, numThreads, [&](int t, int from, int to) {
+        if (from >= to) {
+            return;
+        }
+        const int *quantities = &store.getQuantities().get(0);
+        for (int w = from >> 6; w < (to + 63) >> 6; w++) {
+            for (unsigned long long bits = live[w]; bits != 0; bits &= bits - 1) {
+                partial[t].add(quantities[(w << 6) + __builtin_ctzll(bits)]);
+            }
+        }
+    });
+
+    Reduction total;
+    for (int t = 0; t < (numThreads > 0 ? numThreads : 1); t++) {
+        total.add(partial[t]);
+    }
+    delete[] partial;
+    return total.result(op);
+}
+
+inline List1D<AttributeGroup> InventoryManager::groupBy(const string &attributeName, double start, double width,
+                                                 int buckets, int numThreads) const
+{
+    if (!(width > 0) || buckets <= 0) {
+        throw invalid_argument("groupBy: width and buckets must be positive!");
+    }
+    int slots = store.slotCount();
+    if (numThreads <= 0) {
+        numThreads = thread::hardware_concurrency();
+    }
+    int partials = numThreads > 0 ? numThreads : 1;
+    int *counts = new int[partials * buckets]();
+    long long *quantities = new long long[partials * buckets]();
+    const int *quantityArray = slots > 0 ? &store.getQuantities().get(0) : nullptr;
+    double end = start + width * buckets;
+    forChunks(slots, numThreads, [&](int t, int from, int to) {
+        int *count = counts + t * buckets;
+        long long *quantity = quantities + t * buckets;
+        forSelected(attributeName, start, end, from, to, [&](int slot, double value) {
+            if (value >= end) {
+                return;
+            }
+            // (value - start) / width may round up to buckets just below end
+            int b = (int)((value - start) / width);
+            if (b >= buckets) {
+                b = buckets - 1;
+            }
+            count[b] += 1;
+            quantity[b] += quantityArray[slot];
+        });
+    });
+
+    List1D<AttributeGroup> groups(buckets);
+    for (int b = 0; b < buckets; b++) {
+        AttributeGroup group(start + width * b, start + width * (b + 1));
+        for (int t = 0; t < partials; t++) {
+            group.count += counts[t * buckets + b];
+            group.quantity += quantities[t * buckets + b];
+        }
+        groups.add(group);
+    }
+    delete[] counts;
+    delete[] quantities;
+    return groups;
+}
+
+/*
+ * removeDuplicates: products with the same name and the same attributes
+ *      (same names in the same order, same values) are merged into the
+ *      first of them, with the sum of their quantities.
+ *      One pass with a hash table of the first occurrences (open
+ *      addressing over row numbers), then one compaction: O(n) expected.
+ */
+inline void InventoryManager::removeDuplicates()
+{
+    int n = size();
+    if (n < 2) {
+        return;
+    }
+    store.purge(); // row == slot from here on
+
+    int capacity = 1;
+    while (capacity < 2 * n) {
+        capacity <<= 1;
+    }
+    int mask = capacity - 1;
+    int *slots = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        slots[i] = -1;
+    }
+
+    Bitmap keep(n, true);
+    bool found = false;
+    for (int r = 0; r < n; r++) {
+        int position = (int)(store.rowHash(r) & mask);
+        while (slots[position] != -1 && !store.sameRow(slots[position], r)) {
+            position = (position + 1) & mask;
+        }
+        if (slots[position] == -1) {
+            slots[position] = r;
+        } else {
+            int first = slots[position];
+            store.setQuantity(first, store.getQuantity(first) + store.getQuantity(r));
+            keep.set(r, false);
+            found = true;
+        }
+    }
+    delete[] slots;
+
+    if (found) {
+        store.compact(keep);
+    }
+}
+
+inline InventoryManager InventoryManager::merge(const InventoryManager &inv1,
+                                         const InventoryManager &inv2)
+{
+    const InventoryManager *inventories[] = {&inv1, &inv2};
+    return mergeRows(inventories, 2, false, false);
+}
+
+inline InventoryManager InventoryManager::mergeAll(InventoryManager *inventories[], int count,
+                                            bool sortedByName)
+{
+    for (int i = 0; i < count; i++) {
+        if (inventories[i] == nullptr) {
+            throw invalid_argument("mergeAll: null inventory!");
+        }
+        for (int j = 0; j < i; j++) {
+            if (inventories[j] == inventories[i]) {
+                throw invalid_argument("mergeAll: the same inventory is given twice!");
+            }
+        }
+        if (sortedByName) {
+            const InventoryColumns &source = inventories[i]->store;
+            const Bitmap &live = source.getLive();
+            const string *previous = nullptr;
+            for (int slot = live.nextSet(0); slot != -1; slot = live.nextSet(slot + 1)) {
+                const string &name = source.getNames().get(slot);
+                if (previous != nullptr && name < *previous) {
+                    throw invalid_argument("mergeAll: an inventory is not sorted by name!");
                 }
+                previous = &name;
             }
         }
     }
 
-    return validNames;
+    InventoryManager result = mergeRows(inventories, count, true, sortedByName);
+    for (int i = 0; i < count; i++) {
+        inventories[i]->store.clear();
+    }
+    return result;
 }
 
-inline void InventoryManager::removeDuplicates()
+/*
+ * mergeRows: one pass to map the columns of every input and reserve the
+ *      whole result, then each live slot is appended once, straight from
+ *      the input's arrays (moving the names out when "move" is set: the
+ *      inputs are only const to share the code with merge).
+ *      sortedByName: a heap holds the head of every input; the rows of one
+ *      name arrive together, so a duplicate is looked for only among the
+ *      rows of the current name already in the result.
+ */
+inline InventoryManager InventoryManager::mergeRows(const InventoryManager *const inventories[], int count,
+                                             bool move, bool sortedByName)
 {
-    for (int i = 0; i < size() - 1; i++) {
-        for (int j = i + 1; j < size();) { // Do not increment `j` here
-            bool isDuplicate = false;
+    InventoryManager result;
+    InventoryColumns &out = result.store;
+    int **columnMaps = new int *[count + 1];
+    int slots = 0, cells = 0;
+    for (int i = 0; i < count; i++) {
+        columnMaps[i] = out.mapColumns(inventories[i]->store);
+        slots += inventories[i]->store.rows();
+        cells += inventories[i]->store.cellCount();
+    }
+    out.reserve(slots, cells);
+
+    if (!sortedByName) {
+        for (int i = 0; i < count; i++) {
+            InventoryColumns &source = const_cast<InventoryColumns &>(inventories[i]->store);
+            const Bitmap &live = source.getLive();
+            for (int slot = live.nextSet(0); slot != -1; slot = live.nextSet(slot + 1)) {
+                out.appendSlot(source, slot, columnMaps[i], move);
+            }
+        }
+    } else {
+        Heap<MergeCursor> heads(&MergeCursor::compare);
+        heads.reserve(count);
+        for (int i = 0; i < count; i++) {
+            int slot = inventories[i]->store.getLive().nextSet(0);
+            if (slot != -1) {
+                heads.push(MergeCursor(&inventories[i]->store.getNames().get(slot), i, slot));
+            }
+        }
 
-            // Check if product names match
-            if (productNames.get(i) == productNames.get(j)) {
-                // Check if attributes match
-                List1D<InventoryAttribute> row1 = attributesMatrix.getRow(i);
-                List1D<InventoryAttribute> row2 = attributesMatrix.getRow(j);
+        int groupStart = 0; // first row of the current name in the result
+        while (!heads.empty()) {
+            MergeCursor head = heads.pop();
+            InventoryColumns &source = const_cast<InventoryColumns &>(inventories[head.source]->store);
+            if (groupStart < out.rows() && out.getName(groupStart) != *head.name) {
+                groupStart = out.rows();
+            }
 
-                if (row1.toString() == row2.toString()) {
-                    isDuplicate = true;
+            int duplicate = -1;
+            for (int row = groupStart; row < out.rows() && duplicate == -1; row++) {
+                if (out.sameSlot(row, source, head.slot)) {
+                    duplicate = row;
                 }
             }
-
-            if (isDuplicate) {
-                // Sum the quantities of the duplicate products
-                int newQuantity = quantities.get(i) + quantities.get(j);
-                quantities.set(i, newQuantity);
-
-                // Remove the duplicate product
-                removeProduct(j);
-                // Do not increment `j` because the size has changed
+            if (duplicate != -1) {
+                out.setQuantity(duplicate, out.getQuantity(duplicate) + source.getQuantities().get(head.slot));
             } else {
-                j++; // Increment `j` only if no duplicate was removed
+                out.appendSlot(source, head.slot, columnMaps[head.source], move);
+            }
+
+            int next = source.getLive().nextSet(head.slot + 1);
+            if (next != -1) {
+                heads.push(MergeCursor(&source.getNames().get(next), head.source, next));
             }
         }
     }
+
+    for (int i = 0; i < count; i++) {
+        delete[] columnMaps[i];
+    }
+    delete[] columnMaps;
+    return result;
 }
 
-inline InventoryManager InventoryManager::merge(const InventoryManager &inv1,
-                                         const InventoryManager &inv2)
+inline double InventoryManager::Reduction::result(AggregateOp op) const
 {
-    // TODO
-    List2D<InventoryAttribute> newAttributesMatrix;
-    List1D<string> newProductNames;
-    List1D<int> newQuantities;
-
-    for (int i = 0; i < inv1.size(); i++) {
-        newAttributesMatrix.setRow(newAttributesMatrix.rows(), inv1.getProductAttributes(i));
-        newProductNames.add(inv1.getProductName(i));
-        newQuantities.add(inv1.getProductQuantity(i));
+    switch (op) {
+    case SUM:
+        return sum;
+    case COUNT:
+        return count;
+    case MIN:
+        return count == 0 ? NAN : min;
+    case MAX:
+        return count == 0 ? NAN : max;
+    case AVG:
+        return count == 0 ? NAN : sum / count;
     }
+    throw invalid_argument("Unknown aggregate!");
+}
 
-    for (int i = 0; i < inv2.size(); i++) {
-        newAttributesMatrix.setRow(newAttributesMatrix.rows(), inv2.getProductAttributes(i));
-        newProductNames.add(inv2.getProductName(i));
-        newQuantities.add(inv2.getProductQuantity(i));
+/*
+ * forChunks: fn(t, from, to) for numThreads chunks of the slots, the
+ *      first one on the calling thread. The chunk bounds are multiples of
+ *      64 (but the last); below PARALLEL_QUERY_MIN slots, one chunk.
+ */
+template <class Fn>
+inline void InventoryManager::forChunks(int slots, int numThreads, Fn fn)
+{
+    int words = (slots + 63) / 64;
+    if (numThreads > words) {
+        numThreads = words;
+    }
+    if (numThreads < 1 || slots < PARALLEL_QUERY_MIN) {
+        numThreads = 1;
+    }
+    auto bound = [&](int t) {
+        int slot = (int)((long long)words * t / numThreads) * 64;
+        return slot < slots ? slot : slots;
+    };
+
+    thread *workers = new thread[numThreads - 1];
+    for (int t = 1; t < numThreads; t++) {
+        workers[t - 1] = thread([&fn, &bound, t] { fn(t, bound(t), bound(t + 1)); });
+    }
+    fn(0, bound(0), bound(1));
+    for (int t = 1; t < numThreads; t++) {
+        workers[t - 1].join();
     }
+    delete[] workers;
+}
 
-    return InventoryManager(newAttributesMatrix, newProductNames, newQuantities);
+/*
+ * forSelected: fn(slot, value) for every live value of attributeName in
+ *      [minValue, maxValue] among the slots from .. to - 1 ("from" is a
+ *      multiple of 64), column by column. The range is decided 64 values
+ *      at a time by RangeFilter, and a word where every value is selected
+ *      is read as a plain loop.
+ */
+template <class Fn>
+inline void InventoryManager::forSelected(const string &attributeName, double minValue, double maxValue,
+                                          int from, int to, Fn fn) const
+{
+    if (from >= to) {
+        return;
+    }
+    const unsigned long long *live = store.getLive().data();
+    unsigned long long bits[16];
+    for (int id = store.findColumn(attributeName); id != -1; id = store.column(id).next) {
+        const InventoryColumns::Column &col = store.column(id);
+        const double *values = &col.values.get(0);
+        const unsigned long long *valid = col.valid.data();
+        for (int block = from; block < to; block += 64 * 16) {
+            int count = to - block < 64 * 16 ? to - block : 64 * 16;
+            RangeFilter::selectRange(values + block, count, minValue, maxValue, bits);
+            for (int w = 0; w < (count + 63) / 64; w++) {
+                int base = block + w * 64;
+                unsigned long long word = bits[w] & valid[base >> 6] & live[base >> 6];
+                if (word == ~0ULL) {
+                    for (int i = 0; i < 64; i++) {
+                        fn(base + i, values[base + i]);
+                    }
+                } else {
+                    for (; word != 0; word &= word - 1) {
+                        int slot = base + __builtin_ctzll(word);
+                        fn(slot, values[slot]);
+                    }
+                }
+            }
+        }
+    }
 }
 
 inline void InventoryManager::split(InventoryManager &section1,
                              InventoryManager &section2,
                              double ratio) const
 {
-    // TODO
     double size1 = size() * ratio;
     int size1int = size1;
     if (size1 > size1int) {
@@ -631,44 +3081,82 @@ inline void InventoryManager::split(InventoryManager &section1,
     }
 
     int size2 = size() - size1;
+    int count1 = size1;
+    if (count1 < 0 || size2 < 0) {
+        throw out_of_range("Index is invalid!"); // ratio outside [0, 1]
+    }
 
-    int curr = 0;
-    for (int i = 0; i < size1; i++) {
-        section1.addProduct(getProductAttributes(curr), getProductName(curr), getProductQuantity(curr));
-        curr++;
+    // slot by slot, straight from the columns (no List1D row per product)
+    InventoryColumns &source = const_cast<InventoryColumns &>(store);
+    int *columnMap1 = section1.store.mapColumns(store);
+    int *columnMap2 = section2.store.mapColumns(store);
+    int boundary = size2 > 0 ? store.getRowStarts().get(store.slotOf(count1)) : store.cellCount();
+    section1.store.reserve(section1.store.slotCount() + count1, section1.store.cellCount() + boundary);
+    section2.store.reserve(section2.store.slotCount() + size2, section2.store.cellCount() + store.cellCount() - boundary);
+    int slot = store.getLive().nextSet(0);
+    for (int i = 0; i < count1; i++) {
+        section1.store.appendSlot(source, slot, columnMap1, false);
+        slot = store.getLive().nextSet(slot + 1);
     }
     for (int i = 0; i < size2; i++) {
-        section2.addProduct(getProductAttributes(curr), getProductName(curr), getProductQuantity(curr));
-        curr++;
+        section2.store.appendSlot(source, slot, columnMap2, false);
+        slot = store.getLive().nextSet(slot + 1);
     }
+    delete[] columnMap1;
+    delete[] columnMap2;
+}
+
+inline InventoryView InventoryManager::view() const
+{
+    return InventoryView(*this);
+}
+
+inline QueryBuilder InventoryManager::select() const
+{
+    return QueryBuilder(*this);
+}
+
+inline void InventoryManager::split(InventoryView &section1,
+                             InventoryView &section2,
+                             double ratio) const
+{
+    view().split(section1, section2, ratio);
 }
 
 inline List2D<InventoryAttribute> InventoryManager::getAttributesMatrix() const
 {
-    // TODO
-    return attributesMatrix;
+    List2D<InventoryAttribute> matrix;
+    for (int i = 0; i < size(); i++) {
+        matrix.setRow(matrix.rows(), store.getRow(i));
+    }
+    return matrix;
 }
 
 inline List1D<string> InventoryManager::getProductNames() const
 {
-    // TODO
-    return productNames;
+    List1D<string> list(size());
+    for (int i = 0; i < size(); i++) {
+        list.add(store.getName(i));
+    }
+    return list;
 }
 
 inline List1D<int> InventoryManager::getQuantities() const
 {
-    // TODO
-    return quantities;
+    List1D<int> list(size());
+    for (int i = 0; i < size(); i++) {
+        list.add(store.getQuantity(i));
+    }
+    return list;
 }
 
 inline string InventoryManager::toString() const
 {
-    // TODO
     stringstream ss;
     ss << "InventoryManager[" << endl;
-    ss << "  AttributesMatrix: " << attributesMatrix.toString() << "," << endl;
-    ss << "  ProductNames: " << productNames.toString() << "," << endl;
-    ss << "  Quantities: " << quantities.toString() << endl;
+    ss << "  AttributesMatrix: " << getAttributesMatrix().toString() << "," << endl;
+    ss << "  ProductNames: " << getProductNames().toString() << "," << endl;
+    ss << "  Quantities: " << getQuantities().toString() << endl;
     ss << "]";
 
     return ss.str();
@@ -676,14 +3164,545 @@ inline string InventoryManager::toString() const
 
 inline InventoryManager &InventoryManager::operator=(const InventoryManager &other)
 {
-    // TODO
     if (this != &other) {
-        attributesMatrix = other.attributesMatrix;
-        productNames = other.productNames;
-        quantities = other.quantities;
+        store = other.store;
+    }
+
+    return *this;
+}
+
+inline InventoryManager &InventoryManager::operator=(InventoryManager &&other)
+{
+    if (this != &other) {
+        store = std::move(other.store);
+    }
+
+    return *this;
+}
+
+// -------------------- InventoryView Method Definitions --------------------
+inline InventoryView::InventoryView()
+    : inventory(nullptr), rowList(nullptr), offset(0), length(0)
+{
+}
+
+inline InventoryView::InventoryView(const InventoryManager &inventory)
+    : inventory(&inventory), rowList(nullptr), offset(0), length(inventory.size())
+{
+}
+
+inline InventoryView::InventoryView(const InventoryManager &inventory, int offset, int length)
+    : inventory(&inventory), rowList(nullptr), offset(offset), length(length)
+{
+    if (offset < 0 || length < 0 || offset > inventory.size() - length) {
+        throw out_of_range("View range is out of range!");
+    }
+}
+
+inline InventoryView::InventoryView(const InventoryManager &inventory, const int *rows, int count)
+    : inventory(&inventory), rowList(rows), offset(0), length(count)
+{
+    for (int i = 0; i < count; i++) {
+        if (rows[i] < 0 || rows[i] >= inventory.size()) {
+            throw out_of_range("Index is invalid!");
+        }
+    }
+}
+
+inline int InventoryView::size() const
+{
+    return length;
+}
+
+inline int InventoryView::rowOf(int index) const
+{
+    if (index < 0 || index >= length) {
+        throw out_of_range("Index is invalid!");
+    }
+    return rowList == nullptr ? offset + index : rowList[offset + index];
+}
+
+inline List1D<InventoryAttribute> InventoryView::getProductAttributes(int index) const
+{
+    return inventory->store.getRow(rowOf(index));
+}
+
+inline string InventoryView::getProductName(int index) const
+{
+    return inventory->store.getName(rowOf(index));
+}
+
+inline int InventoryView::getProductQuantity(int index) const
+{
+    return inventory->store.getQuantity(rowOf(index));
+}
+
+inline AttributeSpan InventoryView::attributesOf(int index) const
+{
+    return AttributeSpan(inventory->store, rowOf(index));
+}
+
+/*
+ * query: same result as InventoryManager::query restricted to the view,
+ *      ties in view order.
+ *      Range view: the inventory's sorted index, cut to the view's slots.
+ *      List view: one pass over the listed rows, then a sort of the hits:
+ *      O(size() + k log k).
+ */
+inline List1D<string> InventoryView::query(string attributeName, const double &minValue,
+                                    const double &maxValue, int minQuantity, bool ascending) const
+{
+    if (length == 0) {
+        return List1D<string>();
+    }
+    const InventoryColumns &store = inventory->store;
+    if (rowList == nullptr) {
+        return inventory->queryRange(attributeName, minValue, maxValue, minQuantity, ascending,
+                                     store.slotOf(offset), store.slotOf(offset + length - 1) + 1, 1);
+    }
+
+    List1D<string> validNames;
+    int firstColumn = store.findColumn(AttributeNames::find(attributeName));
+    if (firstColumn == -1 || !(minValue <= maxValue)) {
+        return validNames;
+    }
+
+    // (value, position in the view) of every hit
+    pair<double, int> *hits = new pair<double, int>[length];
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        int slot = store.slotOf(rowList[offset + i]);
+        if (store.getQuantities().get(slot) < minQuantity) {
+            continue;
+        }
+        for (int id = firstColumn; id != -1; id = store.column(id).next) {
+            const InventoryColumns::Column &col = store.column(id);
+            if (col.valid.get(slot) && col.values.get(slot) >= minValue && col.values.get(slot) <= maxValue) {
+                hits[count++] = make_pair(col.values.get(slot), i);
+                break;
+            }
+        }
+    }
+    if (ascending) {
+        sort(hits, hits + count);
+    } else {
+        sort(hits, hits + count, [](const pair<double, int> &a, const pair<double, int> &b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+    }
+    for (int i = 0; i < count; i++) {
+        validNames.add(store.getNames().get(store.slotOf(rowList[offset + hits[i].second])));
+    }
+    delete[] hits;
+    return validNames;
+}
+
+inline InventoryView InventoryView::slice(int offset, int length) const
+{
+    if (offset < 0 || length < 0 || offset > this->length - length) {
+        throw out_of_range("View range is out of range!");
+    }
+    InventoryView view(*this);
+    view.offset += offset;
+    view.length = length;
+    return view;
+}
+
+/*
+ * split: the first ceil(size() * ratio) products, then the rest, as in
+ *      InventoryManager::split; both sections share this view's rows.
+ */
+inline void InventoryView::split(InventoryView &section1,
+                          InventoryView &section2,
+                          double ratio) const
+{
+    double size1 = length * ratio;
+    int size1int = size1;
+    if (size1 > size1int) {
+        size1int += 1;
+    }
+    if (size1int < 0) {
+        size1int = 0;
+    }
+    if (size1int > length) {
+        size1int = length;
+    }
+    section1 = slice(0, size1int);
+    section2 = slice(size1int, length - size1int);
+}
+
+// -------------------- QueryBuilder Method Definitions --------------------
+inline QueryBuilder::QueryBuilder(const InventoryManager &inventory)
+    : inventory(&inventory), conjunctions(1), orderKind(NO_ORDER), orderAscending(true),
+      skip(0), take(-1)
+{
+}
+
+inline QueryBuilder &QueryBuilder::whereAttribute(const string &attributeName, double minValue, double maxValue)
+{
+    Predicate predicate;
+    predicate.kind = ATTRIBUTE;
+    predicate.text = attributeName;
+    predicate.minValue = minValue;
+    predicate.maxValue = maxValue;
+    return add(predicate);
+}
+
+inline QueryBuilder &QueryBuilder::whereNamePrefix(const string &prefix)
+{
+    Predicate predicate;
+    predicate.kind = NAME_PREFIX;
+    predicate.text = prefix;
+    return add(predicate);
+}
+
+inline QueryBuilder &QueryBuilder::whereQuantity(int minQuantity, int maxQuantity)
+{
+    Predicate predicate;
+    predicate.kind = QUANTITY;
+    predicate.minValue = minQuantity;
+    predicate.maxValue = maxQuantity;
+    return add(predicate);
+}
+
+/* orWhere: an empty conjunction is never started (it would match everything) */
+inline QueryBuilder &QueryBuilder::orWhere()
+{
+    if (predicates.size() > 0 && predicates.get(predicates.size() - 1).conjunction == conjunctions - 1) {
+        conjunctions++;
+    }
+    return *this;
+}
+
+inline QueryBuilder &QueryBuilder::orderByAttribute(const string &attributeName, bool ascending)
+{
+    orderKind = BY_ATTRIBUTE;
+    orderName = attributeName;
+    orderAscending = ascending;
+    return *this;
+}
+
+inline QueryBuilder &QueryBuilder::orderByQuantity(bool ascending)
+{
+    orderKind = BY_QUANTITY;
+    orderName = "quantity";
+    orderAscending = ascending;
+    return *this;
+}
+
+inline QueryBuilder &QueryBuilder::offset(int count)
+{
+    if (count < 0) {
+        throw invalid_argument("Offset must not be negative!");
+    }
+    skip = count;
+    return *this;
+}
+
+inline QueryBuilder &QueryBuilder::limit(int count)
+{
+    if (count < -1) {
+        throw invalid_argument("Limit must be -1 or non-negative!");
+    }
+    take = count;
+    return *this;
+}
+
+inline List1D<int> QueryBuilder::rows() const
+{
+    XArrayList<int> slots = resultSlots();
+    List1D<int> result(slots.size());
+    for (int i = 0; i < slots.size(); i++) {
+        result.add(inventory->store.rowOfSlot(slots.get(i)));
+    }
+    return result;
+}
+
+inline List1D<string> QueryBuilder::names() const
+{
+    XArrayList<int> slots = resultSlots();
+    const XArrayList<string> &names = inventory->store.getNames();
+    List1D<string> result(slots.size());
+    for (int i = 0; i < slots.size(); i++) {
+        result.add(names.get(slots.get(i)));
+    }
+    return result;
+}
+
+inline string QueryBuilder::explain() const
+{
+    stringstream os;
+    os << setprecision(3);
+    os << "plan over " << inventory->store.rows() << " products";
+    int shown = 0;
+    for (int c = 0; c < conjunctions; c++) {
+        XArrayList<Step> steps = plan(c);
+        if (steps.size() == 0 && predicates.size() > 0) {
+            continue;
+        }
+        os << "\nconjunction " << (c + 1) << (shown++ > 0 ? " (OR)" : "") << ":";
+        int from = 0;
+        if (steps.size() == 0 || predicates.get(steps.get(0).predicate).kind == QUANTITY) {
+            os << "\n  full scan   " << inventory->store.rows() << " products";
+        } else {
+            const Step &driver = steps.get(0);
+            os << "\n  index scan  " << describe(predicates.get(driver.predicate)) << ": "
+               << driver.entries << " entries, selectivity " << driver.selectivity;
+            from = 1;
+        }
+        for (int k = from; k < steps.size(); k++) {
+            const Step &step = steps.get(k);
+            const Predicate &predicate = predicates.get(step.predicate);
+            os << "\n  filter      " << describe(predicate) << ": selectivity " << step.selectivity
+               << (predicate.kind == QUANTITY ? " (sampled)" : " (index)");
+        }
+    }
+    os << "\norder: ";
+    if (orderKind == NO_ORDER) {
+        os << "product order";
+    } else {
+        os << orderName << (orderAscending ? " ascending" : " descending");
+    }
+    os << ", offset " << skip << ", ";
+    if (take < 0) {
+        os << "no limit";
+    } else {
+        os << "limit " << take << (orderKind == NO_ORDER ? "" : " (top-k)");
     }
+    return os.str();
+}
 
+inline QueryBuilder &QueryBuilder::add(const Predicate &predicate)
+{
+    predicates.add(predicate);
+    predicates.get(predicates.size() - 1).conjunction = conjunctions - 1;
     return *this;
 }
 
+/*
+ * plan: the steps of one conjunction. First the driver, the indexed
+ *      predicate with the fewest index entries in range (if any), then the
+ *      others by increasing estimated selectivity (stable: ties keep the
+ *      order they were added in).
+ */
+inline XArrayList<QueryBuilder::Step> QueryBuilder::plan(int conjunction) const
+{
+    const InventoryColumns &store = inventory->store;
+    int rows = store.rows();
+    int samples = rows < ESTIMATE_SAMPLE ? rows : ESTIMATE_SAMPLE;
+    XArrayList<Step> steps;
+    int driver = -1;
+    for (int i = 0; i < predicates.size(); i++) {
+        const Predicate &predicate = predicates.get(i);
+        if (predicate.conjunction != conjunction) {
+            continue;
+        }
+        Step step;
+        step.predicate = i;
+        if (predicate.kind != QUANTITY) {
+            if (predicate.kind == ATTRIBUTE) {
+                step.firstColumn = store.findColumn(AttributeNames::find(predicate.text));
+            }
+            int first, last;
+            indexRange(predicate, first, last);
+            step.entries = last - first;
+            step.selectivity = rows == 0 ? 0 : (step.entries < rows ? (double)step.entries / rows : 1);
+            if (driver == -1 || step.entries < steps.get(driver).entries) {
+                driver = steps.size();
+            }
+        } else {
+            int hits = 0;
+            for (int s = 0; s < samples; s++) {
+                if (matches(step, store.slotOf((int)((long long)s * rows / samples)))) {
+                    hits++;
+                }
+            }
+            step.selectivity = samples == 0 ? 0 : (double)hits / samples;
+        }
+        steps.add(step);
+    }
+    if (steps.size() == 0) {
+        return steps;
+    }
+
+    Step *begin = &steps.get(0);
+    if (driver != -1) {
+        rotate(begin, begin + driver, begin + driver + 1);
+        begin++;
+    }
+    stable_sort(begin, &steps.get(0) + steps.size(), [](const Step &lhs, const Step &rhs) {
+        return lhs.selectivity < rhs.selectivity;
+    });
+    return steps;
+}
+
+/*
+ * indexRange: the entries [first, last) of the predicate's index in range:
+ *      of sortedIndex for an attribute, of slotsByName for a name prefix
+ */
+inline void QueryBuilder::indexRange(const Predicate &predicate, int &first, int &last) const
+{
+    const InventoryColumns &store = inventory->store;
+    if (predicate.kind == NAME_PREFIX) {
+        store.prefixRange(predicate.text, first, last);
+        return;
+    }
+    first = last = 0;
+    int nameId = AttributeNames::find(predicate.text);
+    if (store.findColumn(nameId) == -1 || !(predicate.minValue <= predicate.maxValue)) {
+        return;
+    }
+    const XArrayList<InventoryColumns::IndexEntry> &index = store.sortedIndex(nameId);
+    if (index.size() == 0) {
+        return;
+    }
+    const InventoryColumns::IndexEntry *entries = &index.get(0);
+    const InventoryColumns::IndexEntry *end = entries + index.size();
+    first = lower_bound(entries, end, predicate.minValue,
+                        [](const InventoryColumns::IndexEntry &entry, double value) {
+                            return entry.value < value;
+                        }) - entries;
+    last = upper_bound(entries, end, predicate.maxValue,
+                       [](double value, const InventoryColumns::IndexEntry &entry) {
+                           return value < entry.value;
+                       }) - entries;
+}
+
+inline bool QueryBuilder::matches(const Step &step, int slot) const
+{
+    const InventoryColumns &store = inventory->store;
+    const Predicate &predicate = predicates.get(step.predicate);
+    if (predicate.kind == ATTRIBUTE) {
+        for (int id = step.firstColumn; id != -1; id = store.column(id).next) {
+            const InventoryColumns::Column &col = store.column(id);
+            double value = col.values.get(slot);
+            if (col.valid.get(slot) && value >= predicate.minValue && value <= predicate.maxValue) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (predicate.kind == NAME_PREFIX) {
+        return store.getNames().get(slot).compare(0, predicate.text.length(), predicate.text) == 0;
+    }
+    int quantity = store.getQuantities().get(slot);
+    return quantity >= predicate.minValue && quantity <= predicate.maxValue;
+}
+
+inline string QueryBuilder::describe(const Predicate &predicate) const
+{
+    stringstream os;
+    if (predicate.kind == NAME_PREFIX) {
+        os << "name starts with \"" << predicate.text << "\"";
+    } else if (predicate.kind == QUANTITY) {
+        os << "quantity in [" << (long long)predicate.minValue << ", " << (long long)predicate.maxValue << "]";
+    } else {
+        os << predicate.text << " in [" << predicate.minValue << ", " << predicate.maxValue << "]";
+    }
+    return os.str();
+}
+
+/*
+ * resultSlots: the slots of the result, ordered and cut by offset/limit.
+ *      "matched" collects the union of the conjunctions: a slot already
+ *      in it is not checked again by the next ones.
+ */
+inline XArrayList<int> QueryBuilder::resultSlots() const
+{
+    const InventoryColumns &store = inventory->store;
+    const Bitmap &live = store.getLive();
+    Bitmap matched(store.slotCount());
+    for (int c = 0; c < conjunctions; c++) {
+        XArrayList<Step> steps = plan(c);
+        if (steps.size() == 0) {
+            if (predicates.size() == 0) {
+                matched = live;
+            }
+            continue;
+        }
+        auto accepts = [&](int slot, int from) {
+            for (int k = from; k < steps.size(); k++) {
+                if (!matches(steps.get(k), slot)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        const Predicate &driver = predicates.get(steps.get(0).predicate);
+        if (driver.kind != QUANTITY) {
+            int first, last;
+            indexRange(driver, first, last);
+            if (first == last) {
+                continue;
+            }
+            const InventoryColumns::IndexEntry *entries = nullptr;
+            const int *nameOrder = nullptr;
+            if (driver.kind == ATTRIBUTE) {
+                entries = &store.sortedIndex(AttributeNames::find(driver.text)).get(0);
+            } else {
+                nameOrder = &store.slotsByName().get(0);
+            }
+            for (int i = first; i < last; i++) {
+                int slot = entries != nullptr ? entries[i].slot : nameOrder[i];
+                if (store.isLive(slot) && !matched.get(slot) && accepts(slot, 1)) {
+                    matched.set(slot, true);
+                }
+            }
+        } else {
+            for (int slot = live.nextSet(0); slot != -1; slot = live.nextSet(slot + 1)) {
+                if (!matched.get(slot) && accepts(slot, 0)) {
+                    matched.set(slot, true);
+                }
+            }
+        }
+    }
+
+    int count = matched.countOnes();
+    XArrayList<int> slots(0, 0, count + 1);
+    for (int slot = matched.nextSet(0); slot != -1; slot = matched.nextSet(slot + 1)) {
+        slots.add(slot);
+    }
+    int end = (take < 0 || (long long)skip + take > count) ? count : skip + take;
+
+    if (orderKind != NO_ORDER && count > 1 && skip < end) {
+        int firstColumn = orderKind == BY_ATTRIBUTE ? store.findColumn(AttributeNames::find(orderName)) : -1;
+        const InventoryColumns::Column *col = firstColumn == -1 ? nullptr : &store.column(firstColumn);
+        const XArrayList<int> &quantities = store.getQuantities();
+        bool ascending = orderAscending;
+        auto before = [&](int lhs, int rhs) {
+            if (orderKind == BY_ATTRIBUTE) {
+                bool hasLhs = col != nullptr && col->valid.get(lhs) && !std::isnan(col->values.get(lhs));
+                bool hasRhs = col != nullptr && col->valid.get(rhs) && !std::isnan(col->values.get(rhs));
+                if (hasLhs != hasRhs) {
+                    return hasLhs;
+                }
+                if (hasLhs && col->values.get(lhs) != col->values.get(rhs)) {
+                    return ascending ? col->values.get(lhs) < col->values.get(rhs)
+                                     : col->values.get(lhs) > col->values.get(rhs);
+                }
+            } else if (quantities.get(lhs) != quantities.get(rhs)) {
+                return ascending ? quantities.get(lhs) < quantities.get(rhs)
+                                 : quantities.get(lhs) > quantities.get(rhs);
+            }
+            return lhs < rhs;
+        };
+        int *begin = &slots.get(0);
+        if (end < count) {
+            partial_sort(begin, begin + end, begin + count, before);
+        } else {
+            sort(begin, begin + count, before);
+        }
+    }
+
+    if (skip == 0 && end == count) {
+        return slots;
+    }
+    XArrayList<int> result(0, 0, (skip < end ? end - skip : 0) + 1);
+    for (int i = skip; i < end; i++) {
+        result.add(slots.get(i));
+    }
+    return result;
+}
+
 #endif /* INVENTORY_MANAGER_H */
@@ -10,6 +10,7 @@
 #include "inventory.h"
 #include "hash/xMap.h"
 #include "heap/Heap.h"
+#include "heap/RadixHeap.h"
 #include "list/XArrayList.h"
 
 template<int treeOrder>
@@ -21,13 +22,33 @@ public:
         XArrayList<HuffmanNode*> children;
 
         HuffmanNode(char s, int f) : symbol(s), freq(f) {}; //Leaf node
-        HuffmanNode(int f, const  XArrayList<HuffmanNode*>& childs) : freq(f), children(childs) {}; //Internal node
+        HuffmanNode(int f, const  XArrayList<HuffmanNode*>& childs) : symbol('\0'), freq(f), children(childs) {}; //Internal node
     };
 
     HuffmanTree();
     ~HuffmanTree();
 
     void build(XArrayList<pair<char, int>>& symbolsFreqs);
+    /* build(symbolsFreqs, queue): same tree construction, driven by any
+     *      priority queue passed by the caller (it must be empty), e.g.
+     *          Heap<HuffmanNode*>      queue(&HuffmanTree::nodeCompare);
+     *          RadixHeap<HuffmanNode*> queue(&HuffmanTree::nodeKey);
+     *      Nodes popped with equal frequency may be grouped differently
+     *      than build(symbolsFreqs) does; the codes are equally optimal.
+     */
+    void build(XArrayList<pair<char, int>>& symbolsFreqs, IHeap<HuffmanNode*>& queue);
+
+    /* nodeCompare: order used to pick the nodes to merge: lower frequency
+     *      first, then leaves before internal nodes, real symbols before
+     *      dummy ones, then by symbol.
+     */
+    static int nodeCompare(HuffmanNode*& a, HuffmanNode*& b);
+    /* nodeKey: integer key (for RadixHeap) with the same order as
+     *      nodeCompare: frequency in the high bits, tie-break rank in the
+     *      low 10 bits. Internal nodes get the largest rank, so a parent's
+     *      key is never below its children's: the merging is monotone.
+     */
+    static long long nodeKey(HuffmanNode*& node);
     void generateCodes(xMap<char, std::string>& table);
     std::string decode(const std::string& huffmanCode);
 
@@ -52,10 +73,14 @@ public:
     void buildHuffman();
     void printHuffmanTable();
     std::string productToString(const List1D<InventoryAttribute>& attributes, const std::string& name);
+    std::string productToString(const AttributeSpan& attributes, const std::string& name);
     std::string encodeHuffman(const List1D<InventoryAttribute>& attributes, const std::string& name);
     std::string decodeHuffman(const std::string& huffmanCode, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
 
 private:
+    template <class Attributes>
+    static std::string attributesToString(const Attributes& attributes, const std::string& name);
+
     xMap<char, std::string>* huffmanTable;
     InventoryManager* invManager;
     HuffmanTree<treeOrder>* tree;
@@ -81,27 +106,7 @@ inline void HuffmanTree<treeOrder>::build(XArrayList<pair<char, int>>& symbolsFr
 {
     //TODO
     //(a) Create a heap from the given list.
-    Heap<HuffmanNode*> heap([](HuffmanNode*& a, HuffmanNode*& b)->int {
-        if (a->freq < b->freq) return -1;
-        else if (a->freq > b->freq) return 1;
-        else {
-            bool aIsLeaf = a->children.empty();
-            bool bIsLeaf = b->children.empty();
-
-            if (aIsLeaf && !bIsLeaf) return -1;
-            if (!aIsLeaf && bIsLeaf) return 1;
-            
-            bool aIsDummy = (a->symbol == '\0');
-            bool bIsDummy = (b->symbol == '\0');
-
-            if (aIsDummy && !bIsDummy) return 1;
-            if (!aIsDummy && bIsDummy) return -1;
-
-            if (a->symbol < b->symbol) return -1;
-            else if (a->symbol > b->symbol) return 1;
-            else return 0;
-        }
-    });
+    Heap<HuffmanNode*> heap(&HuffmanTree<treeOrder>::nodeCompare);
 
     int heapSize = symbolsFreqs.size(), dummyNodes = 0;
     if ((heapSize - 1) % (treeOrder - 1) != 0) {
@@ -149,6 +154,73 @@ inline void HuffmanTree<treeOrder>::build(XArrayList<pair<char, int>>& symbolsFr
     root = sortedFreqs.get(0);
 }
 
+template <int treeOrder>
+inline void HuffmanTree<treeOrder>::build(XArrayList<pair<char, int>>& symbolsFreqs, IHeap<HuffmanNode*>& queue)
+{
+    //(a) Push one leaf per symbol, plus the dummy leaves needed so that every
+    //internal node gets exactly treeOrder children.
+    int heapSize = symbolsFreqs.size(), dummyNodes = 0;
+    if ((heapSize - 1) % (treeOrder - 1) != 0) {
+        dummyNodes = (treeOrder - 1) - ((heapSize - 1) % (treeOrder - 1));
+    }
+    for (int i = 0; i < heapSize; i++) {
+        pair<char, int> pPair = symbolsFreqs.get(i);
+        queue.push(new HuffmanNode(pPair.first, pPair.second));
+    }
+    for (int i = 0; i < dummyNodes; i++) {
+        queue.push(new HuffmanNode('\0', 0));
+    }
+
+    //(b)-(e) Pop treeOrder nodes, push their parent back.
+    while (queue.size() > 1) {
+        XArrayList<HuffmanNode*> children;
+        int totalFreq = 0;
+        for (int i = 0; i < treeOrder; ++i) {
+            HuffmanNode* child = queue.pop();
+            children.add(child);
+            totalFreq += child->freq;
+        }
+        queue.push(new HuffmanNode(totalFreq, children));
+    }
+
+    //(f) The last remaining node becomes the root of the tree
+    root = queue.pop();
+}
+
+template <int treeOrder>
+inline int HuffmanTree<treeOrder>::nodeCompare(HuffmanNode*& a, HuffmanNode*& b)
+{
+    if (a->freq < b->freq) return -1;
+    else if (a->freq > b->freq) return 1;
+    else {
+        bool aIsLeaf = a->children.empty();
+        bool bIsLeaf = b->children.empty();
+
+        if (aIsLeaf && !bIsLeaf) return -1;
+        if (!aIsLeaf && bIsLeaf) return 1;
+        
+        bool aIsDummy = (a->symbol == '\0');
+        bool bIsDummy = (b->symbol == '\0');
+
+        if (aIsDummy && !bIsDummy) return 1;
+        if (!aIsDummy && bIsDummy) return -1;
+
+        if (a->symbol < b->symbol) return -1;
+        else if (a->symbol > b->symbol) return 1;
+        else return 0;
+    }
+}
+
+template <int treeOrder>
+inline long long HuffmanTree<treeOrder>::nodeKey(HuffmanNode*& node)
+{
+    long long rank;
+    if (!node->children.empty()) rank = 1023;                      //internal
+    else if (node->symbol == '\0') rank = 512;                     //dummy leaf
+    else rank = 256 + (signed char)node->symbol;                   //real leaf, by symbol
+    return ((long long)node->freq << 10) | rank;
+}
+
 template <int treeOrder>
 inline void HuffmanTree<treeOrder>::generateCodes(xMap<char, std::string> &table) {
     // TODO
@@ -238,22 +310,26 @@ inline void InventoryCompressor<treeOrder>::buildHuffman()
         return a.first == b.first;
     });
 
-    // Get product strings
-    std::string productStr = "";
-    for (int i = 0; i < invManager->size(); ++i) {
-        List1D<InventoryAttribute> attributes = invManager->getProductAttributes(i);
-        std::string name = invManager->getProductName(i);
-        productStr += productToString(attributes, name);
+    // Count the characters product by product: the rows are read in place
+    // (attributesOf, names) and no string of the whole inventory is built.
+    // position[ch]: index of ch in symbolsFreqs, -1 before its first
+    // occurrence (the list keeps the order of first occurrence).
+    int position[256];
+    for (int i = 0; i < 256; ++i) {
+        position[i] = -1;
     }
-
-    // Count frequencies of each character in the product string
-    for (int i = 0; i < productStr.length(); ++i) {
-        char ch = productStr[i];
-        int freq = 1;
-        if (symbolsFreqs.contains(make_pair(ch, freq))) {
-            symbolsFreqs.get(symbolsFreqs.indexOf(make_pair(ch, freq))).second++;
-        } else {
-            symbolsFreqs.add(make_pair(ch, freq));
+    NameView names = invManager->names();
+    for (int i = 0; i < invManager->size(); ++i) {
+        std::string productStr = productToString(invManager->attributesOf(i), names[i]);
+        for (size_t j = 0; j < productStr.length(); ++j) {
+            char ch = productStr[j];
+            int &at = position[(unsigned char)ch];
+            if (at != -1) {
+                symbolsFreqs.get(at).second++;
+            } else {
+                at = symbolsFreqs.size();
+                symbolsFreqs.add(make_pair(ch, 1));
+            }
         }
     }
 
@@ -274,6 +350,19 @@ template <int treeOrder>
 inline std::string InventoryCompressor<treeOrder>::productToString(const List1D<InventoryAttribute> &attributes, const std::string &name)
 {
     //TODO
+    return attributesToString(attributes, name);
+}
+
+template <int treeOrder>
+inline std::string InventoryCompressor<treeOrder>::productToString(const AttributeSpan &attributes, const std::string &name)
+{
+    return attributesToString(attributes, name);
+}
+
+template <int treeOrder>
+template <class Attributes>
+inline std::string InventoryCompressor<treeOrder>::attributesToString(const Attributes &attributes, const std::string &name)
+{
     stringstream ss;
 
     ss << name << ":";
@@ -337,6 +426,6 @@ inline std::string InventoryCompressor<treeOrder>::decodeHuffman(const std::stri
     // (c) The method returns the decoded string. At the same time, the product name and
     // attribute list are assigned to nameOutput and attributesOutput, respectively.
     nameOutput = productName;
-    attributesOutput = attributeList;
+    attributesOutput = std::move(attributeList);
     return productString;
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * File:   ConcurrentHeap.h
+ *
+ * ConcurrentHeap<T>: a Heap<T> guarded by one mutex.
+ *  + strict ordering: tryPop always returns the smallest item present;
+ *  + every operation serializes on the lock, so throughput does not grow
+ *    with the number of threads (see MultiQueue<T> for a relaxed queue
+ *    that scales).
+ */
+
+#ifndef CONCURRENTHEAP_H
+#define CONCURRENTHEAP_H
+#include <mutex>
+#include "heap/IConcurrentHeap.h"
+#include "heap/Heap.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ * Items still in the queue are not deleted by the destructor.
+ */
+template<class T>
+class ConcurrentHeap: public IConcurrentHeap<T>{
+protected:
+    Heap<T> heap;
+    mutex lock;
+
+public:
+    ConcurrentHeap(int (*comparator)(T& , T&)=0): heap(comparator){}
+    ConcurrentHeap(const ConcurrentHeap<T>& heap) = delete;
+    ConcurrentHeap<T>& operator=(const ConcurrentHeap<T>& heap) = delete;
+
+    //Inherit from IConcurrentHeap: BEGIN
+    void push(T item){
+        lock_guard<mutex> guard(lock);
+        heap.push(std::move(item));
+    }
+    bool tryPop(T& item){
+        lock_guard<mutex> guard(lock);
+        if(heap.empty()) return false;
+        item = heap.pop();
+        return true;
+    }
+    int size(){
+        lock_guard<mutex> guard(lock);
+        return heap.size();
+    }
+    bool empty(){
+        return size() == 0;
+    }
+    //Inherit from IConcurrentHeap: END
+
+    /* reserve: see Heap<T>::reserve */
+    void reserve(int minCapacity){
+        lock_guard<mutex> guard(lock);
+        heap.reserve(minCapacity);
+    }
+};
+
+#endif /* CONCURRENTHEAP_H */
@@ -0,0 +1,339 @@
+/*
+ * File:   DaryHeap.h
+ *
+ * DaryHeap<T, D>: a (min-)heap where every node has D children.
+ *  + children of "position": D*position + 1 .. D*position + D
+ *  + parent of "position"  : (position - 1)/D
+ *  A larger D makes the tree shallower (log_D n levels) and keeps all the
+ *  children of a node next to each other in memory, at the cost of D-1
+ *  comparisons per level when sifting down.
+ * Storage and sifting follow Heap<T>: raw storage (T needs no default
+ * constructor), hole-based sifts that move items, and relocation by
+ * memcpy for trivially copyable T, by move otherwise.
+ */
+
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include <memory.h>
+#include "heap/IHeap.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ *
+ * function pointer: void (*deleteUserData)(DaryHeap<T, D>* pHeap)
+ *      remove user's data in case that T is a pointer type
+ *      Users should pass &DaryHeap<T, D>::free for "deleteUserData"
+ */
+template<class T, int D = 4>
+class DaryHeap: public IHeap<T>{
+    static_assert(D >= 2, "DaryHeap: arity D must be at least 2");
+
+protected:
+    T *elements;    //raw storage; only elements[0..count-1] are constructed
+    int capacity;   //size of the dynamic array
+    int count;      //current count of elements stored in this heap
+    int (*comparator)(T& lhs, T& rhs);
+    void (*deleteUserData)(DaryHeap<T, D>* pHeap);
+
+public:
+    DaryHeap(   int (*comparator)(T& , T&)=0,
+                void (*deleteUserData)(DaryHeap<T, D>*)=0 );
+    DaryHeap(const DaryHeap<T, D>& heap);
+    DaryHeap<T, D>& operator=(const DaryHeap<T, D>& heap);
+    ~DaryHeap();
+
+    //Inherit from IHeap: BEGIN
+    void push(T item);
+    T pop();
+    const T peek();
+    void remove(T item, void (*removeItemData)(T)=0);
+    bool contains(T item);
+    int size();
+    void heapify(T array[], int size);
+    void clear();
+    bool empty();
+    string toString(string (*item2str)(T&)=0 );
+    //Inherit from IHeap: END
+
+    void println(string (*item2str)(T&)=0 ){
+        cout << toString(item2str) << endl;
+    }
+
+public:
+    static void free(DaryHeap<T, D> *pHeap){
+        for(int idx=0; idx < pHeap->count; idx++) delete pHeap->elements[idx];
+    }
+
+private:
+    bool aLTb(T& a, T& b){
+        return compare(a, b) < 0;
+    }
+    int compare(T& a, T& b){
+        if(comparator != 0) return comparator(a, b);
+        else{
+            if (a < b) return -1;
+            else if(a > b) return 1;
+            else return 0;
+        }
+    }
+
+    static T* allocate(int capacity);
+    static void relocate(T* dest, T* src, int n);
+    void destroyAll();
+    void ensureCapacity(int minCapacity);
+    void reheapUp(int position);
+    void reheapDown(int position);
+    void removeInternalData();
+    void copyFrom(const DaryHeap<T, D>& heap);
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T, int D>
+inline DaryHeap<T, D>::DaryHeap(
+        int (*comparator)(T&, T&),
+        void (*deleteUserData)(DaryHeap<T, D>* ) ){
+    capacity = 10;
+    count = 0;
+    elements = allocate(capacity);
+    this->comparator = comparator;
+    this->deleteUserData = deleteUserData;
+}
+
+template<class T, int D>
+inline DaryHeap<T, D>::DaryHeap(const DaryHeap<T, D>& heap){
+    copyFrom(heap);
+}
+
+template<class T, int D>
+inline DaryHeap<T, D>& DaryHeap<T, D>::operator=(const DaryHeap<T, D>& heap){
+    if(this != &heap){
+        removeInternalData();
+        copyFrom(heap);
+    }
+    return *this;
+}
+
+template<class T, int D>
+inline DaryHeap<T, D>::~DaryHeap(){
+    removeInternalData();
+    comparator = nullptr;
+    deleteUserData = nullptr;
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::push(T item){
+    ensureCapacity(count + 1);
+    new (&elements[count]) T(std::move(item));
+    count += 1;
+    reheapUp(count - 1);
+}
+
+template<class T, int D>
+inline T DaryHeap<T, D>::pop(){
+    if(count == 0)
+        throw std::underflow_error("Calling to pop with the empty heap.");
+
+    T item = std::move(elements[0]);
+    count -= 1;
+    if(count > 0){
+        elements[0] = std::move(elements[count]);
+        reheapDown(0);
+    }
+    elements[count].~T(); //moved-from slot leaves the heap
+    return item;
+}
+
+template<class T, int D>
+inline const T DaryHeap<T, D>::peek(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    return elements[0];
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::remove(T item, void (*removeItemData)(T)){
+    int foundIdx = -1;
+    for(int idx=0; idx < count; idx++){
+        if(compare(elements[idx], item) == 0){
+            foundIdx = idx;
+            break;
+        }
+    }
+    if(foundIdx == -1) return;
+
+    count -= 1;
+    if(foundIdx < count){
+        elements[foundIdx] = std::move(elements[count]);
+        int parent = (foundIdx - 1)/D;
+        if(foundIdx > 0 && aLTb(elements[foundIdx], elements[parent])) reheapUp(foundIdx);
+        else reheapDown(foundIdx);
+    }
+    elements[count].~T();
+    if(removeItemData != 0) removeItemData(item);
+}
+
+template<class T, int D>
+inline bool DaryHeap<T, D>::contains(T item){
+    for(int idx=0; idx < count; idx++){
+        if(compare(elements[idx], item) == 0) return true;
+    }
+    return false;
+}
+
+template<class T, int D>
+inline int DaryHeap<T, D>::size(){
+    return count;
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::heapify(T array[], int size){
+    ensureCapacity(count + size);
+    for(int idx=0; idx < size; idx++){
+        new (&elements[count]) T(array[idx]);
+        count++;
+    }
+    if(count < 2) return; //(count - 2)/D would truncate to 0 below
+    for(int position = (count - 2)/D; position >= 0; position--) reheapDown(position);
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::clear(){
+    removeInternalData();
+
+    capacity = 10;
+    count = 0;
+    elements = allocate(capacity);
+}
+
+template<class T, int D>
+inline bool DaryHeap<T, D>::empty(){
+    return count == 0;
+}
+
+template<class T, int D>
+inline string DaryHeap<T, D>::toString(string (*item2str)(T&)){
+    stringstream os;
+    os << "[";
+    for(int idx=0; idx < count; idx++){
+        if(idx > 0) os << ",";
+        if(item2str != 0) os << item2str(elements[idx]);
+        else os << elements[idx];
+    }
+    os << "]";
+    return os.str();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T, int D>
+inline void DaryHeap<T, D>::ensureCapacity(int minCapacity){
+    if(minCapacity <= capacity) return;
+
+    int newCapacity = capacity * 2;
+    if(newCapacity < minCapacity) newCapacity = minCapacity;
+
+    //allocate first: on std::bad_alloc the heap is left untouched
+    T* newData = allocate(newCapacity);
+    relocate(newData, elements, count);
+    ::operator delete(elements);
+    elements = newData;
+    capacity = newCapacity;
+}
+
+template<class T, int D>
+inline T* DaryHeap<T, D>::allocate(int capacity){
+    return static_cast<T*>(::operator new(capacity*sizeof(T)));
+}
+
+/* relocate: move n constructed items from src to uninitialized dest (see Heap<T>) */
+template<class T, int D>
+inline void DaryHeap<T, D>::relocate(T* dest, T* src, int n){
+    if constexpr (std::is_trivially_copyable<T>::value){
+        if(n > 0) memcpy(static_cast<void*>(dest), static_cast<void*>(src), n*sizeof(T));
+    }
+    else{
+        for(int idx=0; idx < n; idx++){
+            new (&dest[idx]) T(std::move(src[idx]));
+            src[idx].~T();
+        }
+    }
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::destroyAll(){
+    for(int idx=0; idx < count; idx++) elements[idx].~T();
+    count = 0;
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::reheapUp(int position){
+    if(position <= 0) return;
+    T item = std::move(elements[position]);
+    while(position > 0){
+        int parent = (position - 1)/D;
+        if(!aLTb(item, elements[parent])) break;
+        elements[position] = std::move(elements[parent]);
+        position = parent;
+    }
+    elements[position] = std::move(item);
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::reheapDown(int position){
+    T item = std::move(elements[position]);
+    while(true){
+        int firstChild = D*position + 1;
+        if(firstChild >= count) break;
+
+        int lastChild = firstChild + D;
+        if(lastChild > count) lastChild = count;
+        int smallChild = firstChild;
+        for(int child = firstChild + 1; child < lastChild; child++){
+            if(aLTb(elements[child], elements[smallChild])) smallChild = child;
+        }
+
+        if(!aLTb(elements[smallChild], item)) break;
+        elements[position] = std::move(elements[smallChild]);
+        position = smallChild;
+    }
+    elements[position] = std::move(item);
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::removeInternalData(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    destroyAll();
+    ::operator delete(elements);
+}
+
+template<class T, int D>
+inline void DaryHeap<T, D>::copyFrom(const DaryHeap<T, D>& heap){
+    capacity = heap.capacity;
+    count = 0;
+    elements = allocate(capacity);
+    this->comparator = heap.comparator;
+    this->deleteUserData = heap.deleteUserData;
+
+    for(int idx=0; idx < heap.count; idx++){
+        new (&elements[idx]) T(heap.elements[idx]);
+        count++;
+    }
+}
+
+#endif /* DARYHEAP_H */
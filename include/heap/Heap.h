@@ -4,6 +4,9 @@
 #include "heap/IHeap.h"
 #include <sstream>
 #include <iostream>
+#include <utility>
+#include <new>
+#include <type_traits>
 
 #include "list/XArrayList.h"
 
@@ -25,10 +28,11 @@ template<class T>
 class Heap: public IHeap<T>{
 public:
     class Iterator; //forward declaration
+    class OrderedIterator; //forward declaration
     
 protected:
-    T *elements;    //a dynamic array to contain user's data
-    int capacity;   //size of the dynamic array
+    T *elements;    //raw storage; only elements[0..count-1] are constructed
+    int capacity;   //size of the dynamic array (in items)
     int count;      //current count of elements stored in this heap
     int (*comparator)(T& lhs, T& rhs);      //see above
     void (*deleteUserData)(Heap<T>* pHeap); //see above
@@ -49,14 +53,26 @@ public:
     void remove(T item, void (*removeItemData)(T)=0);
     bool contains(T item);
     int size();
-    void heapify(T array[], int size);
+    void heapify(T array[], int size); //replace content, O(size)
     void clear();
     bool empty();
     void heapsort(XArrayList<T>& arrayList);
     void heapsortNoPrint(XArrayList<T>& arrayList);
+    void partialSort(XArrayList<T>& arrayList, int k);
+    XArrayList<T> topK(XArrayList<T>& arrayList, int k);
+    
+    void heapify(XArrayList<T>& arrayList);
+    template<class InputIterator>
+    void heapify(InputIterator first, InputIterator last);
+    void merge(Heap<T>&& other);
     string toString(string (*item2str)(T&)=0 );
     //Inherit from IHeap: END
     
+    /* reserve(int minCapacity): make room for at least minCapacity items,
+     *      so that the next (minCapacity - size()) pushes do not reallocate
+     */
+    void reserve(int minCapacity);
+    
     void println(string (*item2str)(T&)=0 ){
         cout << toString(item2str) << endl;
     }
@@ -68,6 +84,22 @@ public:
         return Iterator(this, false);
     }
     
+    /* orderedBegin/orderedEnd: visit the items in the order pop() would
+     *      return them, without changing the heap. Visiting the first k
+     *      items costs O(k log k). Any change to the heap invalidates the
+     *      iterator.
+     */
+    OrderedIterator orderedBegin(){
+        return OrderedIterator(this, true);
+    }
+    OrderedIterator orderedEnd(){
+        return OrderedIterator(this, false);
+    }
+    /* peekFirst(k): the (at most) k items pop() would return first, in that
+     *      order; the heap is not changed. O(k log k).
+     */
+    XArrayList<T> peekFirst(int k);
+    
 public:
     /* if T is pointer type:
      *     pass the address of method "free" to Heap<T>'s constructor:
@@ -85,6 +117,9 @@ private:
     bool aLTb(T& a, T& b){
         return compare(a, b) < 0;
     }
+    bool before(T& a, T& b, bool reversed){
+        return reversed ? aLTb(b, a) : aLTb(a, b);
+    }
     int compare(T& a, T& b){
         if(comparator != 0) return comparator(a, b);
         else{
@@ -95,10 +130,17 @@ private:
     }
     
     void ensureCapacity(int minCapacity); 
+    static T* allocate(int capacity);
+    static void relocate(T* dest, T* src, int n);
+    void destroyAll();
     void swap(int a, int b);
     void reheapUp(int position);
     void reheapDown(int position);
-    void reheapDown(int position, int lastPosition);
+    void siftDown(T* array, int position, int lastPosition, bool reversed=false);
+    static void printReversed(T* array, int size);
+    static void reverse(T* array, int size);
+    void popBottomUp();
+    void buildHeap();
     int getItem(T item);
     
     void removeInternalData();
@@ -149,6 +191,89 @@ public:
         }
     };
     //Iterator: END
+    
+    //OrderedIterator: BEGIN
+    /*
+     * The frontier is a small heap of positions in "elements": the children
+     * of every visited position, not visited yet. Its smallest item is the
+     * next one in pop order, because every other item of the heap is below
+     * one of the frontier positions.
+     */
+    class OrderedIterator{
+    private:
+        Heap<T>* heap;
+        XArrayList<int> frontier;
+        int rank;   //number of items already visited
+    public:
+        OrderedIterator(Heap<T>* heap=0, bool begin=0){
+            this->heap = heap;
+            this->rank = 0;
+            if(heap == 0) return;
+            if(begin){
+                if(heap->count > 0) frontier.add(0);
+            }
+            else rank = heap->count;
+        }
+        
+        T& operator*(){
+            return this->heap->elements[frontier.get(0)];
+        }
+        bool operator!=(const OrderedIterator& iterator){
+            return this->rank != iterator.rank;
+        }
+        // Prefix ++ overload 
+        OrderedIterator& operator++(){
+            int* positions = &frontier.get(0);
+            int position = positions[0];
+            int last = frontier.size() - 1;
+            positions[0] = positions[last];
+            frontier.removeAt(last);
+            if(last > 0) siftDown();
+            
+            int child = 2*position + 1;
+            if(child < heap->count) add(child);
+            if(child + 1 < heap->count) add(child + 1);
+            rank++;
+            return *this; 
+        }
+        // Postfix ++ overload 
+        OrderedIterator operator++(int){
+            OrderedIterator iterator = *this; 
+            ++*this; 
+            return iterator; 
+        }
+    private:
+        bool less(int a, int b){
+            return heap->aLTb(heap->elements[a], heap->elements[b]);
+        }
+        void add(int position){
+            frontier.add(position);
+            int* positions = &frontier.get(0);
+            int idx = frontier.size() - 1;
+            while(idx > 0){
+                int parent = (idx - 1)/2;
+                if(!less(position, positions[parent])) break;
+                positions[idx] = positions[parent];
+                idx = parent;
+            }
+            positions[idx] = position;
+        }
+        void siftDown(){
+            int* positions = &frontier.get(0);
+            int size = frontier.size();
+            int position = positions[0];
+            int idx = 0;
+            while(2*idx + 1 < size){
+                int child = 2*idx + 1;
+                if(child + 1 < size && less(positions[child + 1], positions[child])) child++;
+                if(!less(positions[child], position)) break;
+                positions[idx] = positions[child];
+                idx = child;
+            }
+            positions[idx] = position;
+        }
+    };
+    //OrderedIterator: END
 };
 
 
@@ -162,7 +287,7 @@ inline Heap<T>::Heap(
         void (*deleteUserData)(Heap<T>* ) ){
     capacity = 10;
     count = 0;
-    elements = new T[capacity];
+    elements = allocate(capacity);
     this->comparator = comparator;
     this->deleteUserData = deleteUserData;
 }
@@ -193,7 +318,7 @@ inline Heap<T>::~Heap(){
 template<class T>
 inline void Heap<T>::push(T item){ //item  = 25
     ensureCapacity(count + 1); //[18, 15, 13, 25 , , ]
-    elements[count] = item;
+    new (&elements[count]) T(std::move(item));
     count += 1; //count = 
     reheapUp(count - 1); // [18, 15, 13, 25 , , ]
 }
@@ -218,10 +343,10 @@ inline T Heap<T>::pop(){
     if(count == 0) 
         throw std::underflow_error("Calling to peek with the empty heap.");
     
-    T item = elements[0]; //item =25
-    elements[0] = elements[count - 1]; //[15, 18, 13, , , ]
+    T item = std::move(elements[0]); //item =25
     count -= 1;
-    reheapDown(0);
+    if(count > 0) popBottomUp(); //[18, 15, 13, , , ]
+    elements[count].~T(); //moved-from slot leaves the heap
     return item;
 }
 
@@ -252,14 +377,17 @@ inline void Heap<T>::remove(T item, void (*removeItemData)(T)){
     if(foundIdx == -1) return;
 
     //CASE 2: found at foundIdx
-    elements[foundIdx] = elements[count - 1]; 
     count -= 1;
-    int parent = (foundIdx - 1) / 2;
-    if (aLTb(elements[foundIdx], elements[parent])) {
-        reheapUp(foundIdx);
-    } else {
-        reheapDown(foundIdx);
+    if (foundIdx < count) { //nothing to fix if the last item was removed
+        elements[foundIdx] = std::move(elements[count]);
+        int parent = (foundIdx - 1) / 2;
+        if (foundIdx > 0 && aLTb(elements[foundIdx], elements[parent])) {
+            reheapUp(foundIdx);
+        } else {
+            reheapDown(foundIdx);
+        }
     }
+    elements[count].~T();
     if(removeItemData != NULL) removeItemData(item); //free item's memory
 }
 
@@ -318,10 +446,74 @@ inline int Heap<T>::size(){
 
 template<class T>
 inline void Heap<T>::heapify(T array[], int size){
-    for (int i = 0; i < size; i++) {
-        ensureCapacity(++count);
-        elements[i] = array[i];
+    heapify(array, array + size);
+}
+
+template<class T>
+inline void Heap<T>::heapify(XArrayList<T>& arrayList){
+    if (arrayList.size() == 0) {
+        heapify((T*)0, (T*)0);
+        return;
+    }
+    T* array = &arrayList.get(0);
+    heapify(array, array + arrayList.size());
+}
+
+/*
+ * heapify(first, last): replace the content of the heap by [first, last).
+ *  (1) count the items and size the buffer once;
+ *  (2) copy the items in;
+ *  (3) Floyd's bottom-up build: reheapDown every internal node, from the
+ *      last one to the root => O(n) in total.
+ * Previous items are discarded as clear() would (deleteUserData applies).
+ * The range is traversed twice, so it must be a forward range (array,
+ * XArrayList::Iterator, std containers, ...).
+ */
+template<class T>
+template<class InputIterator>
+inline void Heap<T>::heapify(InputIterator first, InputIterator last){
+    if (this->deleteUserData != 0) deleteUserData(this);
+    destroyAll();
+
+    int size = 0;
+    for (InputIterator it = first; it != last; ++it) size++;
+    reserve(size);
+
+    for (InputIterator it = first; it != last; ++it) {
+        new (&elements[count]) T(*it);
+        count++;
+    }
+    buildHeap();
+}
+
+/*
+ * merge(other): meld "other" into this heap. Items are moved (relocated)
+ *      from other's buffer to the end of this one, then the concatenated
+ *      buffer is re-heapified in O(n + m). When other is small, its items
+ *      are sifted up one by one instead, O(m log(n + m)).
+ *      other is left empty; both heaps are expected to share the same order.
+ */
+template<class T>
+inline void Heap<T>::merge(Heap<T>&& other){
+    if (this == &other || other.count == 0) return;
+
+    int oldCount = count;
+    reserve(count + other.count);
+    relocate(&elements[count], other.elements, other.count);
+    count += other.count;
+    other.count = 0;
+
+    int moved = count - oldCount;
+    int depth = 0;
+    for (int n = count; n > 1; n >>= 1) depth++;
+    if ((long long)moved * depth < count) {
+        for (int position = oldCount; position < count; position++) reheapUp(position);
     }
+    else buildHeap();
+}
+
+template<class T>
+inline void Heap<T>::buildHeap(){
     int position = count / 2 - 1;
     while (position >= 0) {
         reheapDown(position);
@@ -335,7 +527,7 @@ inline void Heap<T>::clear(){
     
     capacity = 10;
     count = 0;
-    elements = new T[capacity];
+    elements = allocate(capacity);
 }
 
 template<class T>
@@ -343,58 +535,122 @@ inline bool Heap<T>::empty(){
     return count == 0;
 }
 
+/*
+ * heapsort/heapsortNoPrint: sort arrayList in place, in the order defined by
+ *      the comparator (the order in which pop() would return the items).
+ *      The list's own buffer is used as the heap; this heap is not touched.
+ *  (1) build a heap over the buffer;
+ *  (2) repeatedly swap the root to the back: the back fills up with items
+ *      in reverse order;
+ *  (3) reverse the buffer.
+ * heapsort also prints the list (front = smallest) after each step of (2).
+ */
 template<class T>
 inline void Heap<T>::heapsort(XArrayList<T>& arrayList) {
-    clear(); 
-    for (int i = 0; i < arrayList.size(); i++) {
-        ensureCapacity(++count);
-        elements[i] = arrayList.get(i);
-    }
+    int size = arrayList.size();
+    if (size == 0) return;
+    T* array = &arrayList.get(0);
 
-    int position = count / 2 - 1;
-    while (position >= 0) {
-        reheapDown(position, count - 1);
-        position--;
+    for (int position = size / 2 - 1; position >= 0; position--) {
+        siftDown(array, position, size - 1);
     }
 
-    int last = count - 1;
-    while (last > 0) {
-        swap(0, last);
-        reheapDown(0, last - 1);
-        arrayList.clear();
-        for (int i = count - 1; i >= 0; --i) {
-            arrayList.add(elements[i]);
-        }
-        arrayList.println();
-        last--;
+    for (int last = size - 1; last > 0; last--) {
+        std::swap(array[0], array[last]);
+        siftDown(array, 0, last - 1);
+        printReversed(array, size);
     }
+    reverse(array, size);
 }
 
 template<class T>
 inline void Heap<T>::heapsortNoPrint(XArrayList<T>& arrayList) {
-    clear(); 
-    for (int i = 0; i < arrayList.size(); i++) {
-        ensureCapacity(++count);
-        elements[i] = arrayList.get(i);
+    int size = arrayList.size();
+    if (size == 0) return;
+    T* array = &arrayList.get(0);
+
+    for (int position = size / 2 - 1; position >= 0; position--) {
+        siftDown(array, position, size - 1);
     }
 
-    int position = count / 2 - 1;
-    while (position >= 0) {
-        reheapDown(position, count - 1);
-        position--;
+    for (int last = size - 1; last > 0; last--) {
+        std::swap(array[0], array[last]);
+        siftDown(array, 0, last - 1);
     }
+    reverse(array, size);
+}
+
+template<class T>
+inline XArrayList<T> Heap<T>::peekFirst(int k) {
+    if (k > count) k = count;
+    if (k < 0) k = 0;
+    XArrayList<T> result(0, 0, k + 1);
+    OrderedIterator it = orderedBegin();
+    for (int idx = 0; idx < k; idx++, ++it) result.add(*it);
+    return result;
+}
 
-    int last = count - 1;
-    while (last > 0) {
-        swap(0, last);
-        reheapDown(0, last - 1);
-        last--;
+/*
+ * partialSort(arrayList, k): rearrange arrayList in place so that its first
+ *      k items are the k items pop() would return first, in that order.
+ *      The order of the remaining items is unspecified.
+ *      O(n log k) comparisons, no extra memory.
+ */
+template<class T>
+inline void Heap<T>::partialSort(XArrayList<T>& arrayList, int k) {
+    int size = arrayList.size();
+    if (k > size) k = size;
+    if (k <= 0) return;
+    T* array = &arrayList.get(0);
+
+    //array[0..k-1]: reversed heap, array[0] is the worst of the k kept items
+    for (int position = k / 2 - 1; position >= 0; position--) {
+        siftDown(array, position, k - 1, true);
+    }
+    for (int idx = k; idx < size; idx++) {
+        if (aLTb(array[idx], array[0])) {
+            std::swap(array[idx], array[0]);
+            siftDown(array, 0, k - 1, true);
+        }
+    }
+    //sort down: the worst kept item goes to the back each step
+    for (int last = k - 1; last > 0; last--) {
+        std::swap(array[0], array[last]);
+        siftDown(array, 0, last - 1, true);
     }
+}
 
-    arrayList.clear();
-    for (int i = count - 1; i >= 0; --i) {
-        arrayList.add(elements[i]);
+/*
+ * topK(arrayList, k): return the k items pop() would return first, in that
+ *      order, without changing arrayList.
+ *      Only a bounded heap of k items is kept: O(n log k) time, O(k) memory.
+ */
+template<class T>
+inline XArrayList<T> Heap<T>::topK(XArrayList<T>& arrayList, int k) {
+    int size = arrayList.size();
+    if (k > size) k = size;
+    if (k < 0) k = 0;
+
+    XArrayList<T> result(0, 0, k + 1);
+    if (k == 0) return result;
+    T* source = &arrayList.get(0);
+    for (int idx = 0; idx < k; idx++) result.add(source[idx]);
+    T* array = &result.get(0);
+
+    for (int position = k / 2 - 1; position >= 0; position--) {
+        siftDown(array, position, k - 1, true);
+    }
+    for (int idx = k; idx < size; idx++) {
+        if (aLTb(source[idx], array[0])) {
+            array[0] = source[idx];
+            siftDown(array, 0, k - 1, true);
+        }
     }
+    for (int last = k - 1; last > 0; last--) {
+        std::swap(array[0], array[last]);
+        siftDown(array, 0, last - 1, true);
+    }
+    return result;
 }
 
 template<class T>
@@ -422,50 +678,96 @@ inline string Heap<T>::toString(string (*item2str)(T&)){
 //////////////////////// (private) METHOD DEFNITION //////////////////
 //////////////////////////////////////////////////////////////////////
 
+template<class T>
+inline void Heap<T>::reserve(int minCapacity){
+    if(minCapacity <= capacity) return;
+    
+    //allocate first: on std::bad_alloc the heap is left untouched
+    T* new_data = allocate(minCapacity);
+    relocate(new_data, elements, count);
+    ::operator delete(elements);
+    elements = new_data;
+    capacity = minCapacity;
+}
+
 template<class T>
 inline void Heap<T>::ensureCapacity(int minCapacity){
-    if(minCapacity >= capacity){
-        //re-allocate 
-        int old_capacity = capacity;
-        capacity = old_capacity + (old_capacity >> 2);
-        try{
-            T* new_data = new T[capacity];
-            //OLD: memcpy(new_data, elements, capacity*sizeof(T));
-            memcpy(new_data, elements, old_capacity*sizeof(T));
-            delete []elements;
-            elements = new_data;
-        }
-        catch(std::bad_alloc e){
-            e.what();
+    if(minCapacity > capacity){
+        //geometric growth: n pushes => O(log n) reallocations, O(n) moves
+        int new_capacity = 2*capacity;
+        if(new_capacity < minCapacity) new_capacity = minCapacity;
+        reserve(new_capacity);
+    }
+}
+
+template<class T>
+inline T* Heap<T>::allocate(int capacity){
+    return static_cast<T*>(::operator new(capacity*sizeof(T)));
+}
+
+/*
+ * relocate: move n constructed items from src to uninitialized dest,
+ *      leaving src as raw storage.
+ *      memcpy is only valid for trivially copyable T (int, pointers, ...);
+ *      other types (string, Point, structs holding lists, ...) are moved.
+ */
+template<class T>
+inline void Heap<T>::relocate(T* dest, T* src, int n){
+    if constexpr (std::is_trivially_copyable<T>::value){
+        if(n > 0) memcpy(static_cast<void*>(dest), static_cast<void*>(src), n*sizeof(T));
+    }
+    else{
+        for(int idx=0; idx < n; idx++){
+            new (&dest[idx]) T(std::move(src[idx]));
+            src[idx].~T();
         }
     }
 }
 
+template<class T>
+inline void Heap<T>::destroyAll(){
+    for(int idx=0; idx < count; idx++) elements[idx].~T();
+    count = 0;
+}
+
 template<class T>
 inline void Heap<T>::swap(int a, int b){
-    T temp = this->elements[a];
-    this->elements[a] = this->elements[b];
-    this->elements[b] = temp;
+    T temp = std::move(this->elements[a]);
+    this->elements[a] = std::move(this->elements[b]);
+    this->elements[b] = std::move(temp);
 }
 
+/*
+ * reheapUp/reheapDown use the "hole" technique: the item being sifted is
+ * saved once, the elements it passes over are moved into the hole, and the
+ * item is stored once at its final position (one move per level instead
+ * of the three of a swap). Both are iterative, so no stack depth ~ log n.
+ */
 template<class T>
 inline void Heap<T>::reheapUp(int position){
     if(position <= 0) return;
-    int parent = (position-1)/2;
+    T item = std::move(this->elements[position]);
     
-    if(aLTb(this->elements[position], this->elements[parent])){
-        this->swap(position, parent);
-        reheapUp(parent);
+    while(position > 0){
+        int parent = (position-1)/2;
+        if(!aLTb(item, this->elements[parent])) break;
+        this->elements[position] = std::move(this->elements[parent]);
+        position = parent;
     }
+    this->elements[position] = std::move(item);
 }
 
 template<class T>
 inline void Heap<T>::reheapDown(int position){
-    int leftChild = position*2 + 1;
-    int rightChild = position*2 + 2;
     int lastPosition = this->count - 1;
+    if(position*2 + 1 > lastPosition) return;
+    T item = std::move(this->elements[position]);
+
+    while(true){
+        int leftChild = position*2 + 1;
+        int rightChild = position*2 + 2;
+        if(leftChild > lastPosition) break;
 
-    if(leftChild <= lastPosition){
         int smallChild = leftChild; //by default => leftChild valid but rightChild invalid
         if(rightChild <= lastPosition){
             if(aLTb(this->elements[leftChild], this->elements[rightChild])) 
@@ -473,32 +775,92 @@ inline void Heap<T>::reheapDown(int position){
             else smallChild = rightChild;
         }
 
-        if(aLTb(this->elements[smallChild], this->elements[position])){
-            this->swap(smallChild, position);
-            reheapDown(smallChild);
-        }
+        if(!aLTb(this->elements[smallChild], item)) break;
+        this->elements[position] = std::move(this->elements[smallChild]);
+        position = smallChild;
     }
+    this->elements[position] = std::move(item);
 }
 
+/*
+ * siftDown: reheapDown over an external buffer array[0..lastPosition],
+ *      used by the sorting methods.
+ *      reversed = true: the comparator is reversed (the root is the item
+ *      that pop() would return last).
+ */
 template<class T>
-inline void Heap<T>::reheapDown(int position, int lastPosition){
-    int leftChild = position*2 + 1;
-    int rightChild = position*2 + 2;
+inline void Heap<T>::siftDown(T* array, int position, int lastPosition, bool reversed){
+    if(position*2 + 1 > lastPosition) return;
+    T item = std::move(array[position]);
+
+    while(true){
+        int leftChild = position*2 + 1;
+        int rightChild = position*2 + 2;
+        if(leftChild > lastPosition) break;
 
-    if(leftChild <= lastPosition){
         int swapChild = leftChild;
-        
-        if ((rightChild <= lastPosition) && (aLTb(elements[rightChild], elements[leftChild]))) {
+        if ((rightChild <= lastPosition) && (before(array[rightChild], array[leftChild], reversed))) {
             swapChild = rightChild;
-        } else {
-            swapChild = leftChild;
         }
 
-        if (aLTb(elements[swapChild], elements[position])) {
-            swap(swapChild, position);
-            reheapDown(swapChild, lastPosition);
-        }
+        if (!before(array[swapChild], item, reversed)) break;
+        array[position] = std::move(array[swapChild]);
+        position = swapChild;
+    }
+    array[position] = std::move(item);
+}
+
+template<class T>
+inline void Heap<T>::printReversed(T* array, int size){
+    cout << "[";
+    for(int idx = size - 1; idx >= 0; idx--){
+        cout << array[idx];
+        if(idx > 0) cout << ", ";
+    }
+    cout << "]" << endl;
+}
+
+template<class T>
+inline void Heap<T>::reverse(T* array, int size){
+    for(int left = 0, right = size - 1; left < right; left++, right--){
+        std::swap(array[left], array[right]);
+    }
+}
+
+/*
+ * popBottomUp: Floyd's bottom-up deletion, called by pop after the root
+ * was taken out (count already decreased, elements[count] is the old last
+ * item).
+ *  (1) walk the hole from the root down to a leaf, always along the smaller
+ *      child: one comparison per level instead of two;
+ *  (2) sift the old last item up from that leaf; it usually stops after a
+ *      level or two since it came from the bottom of the heap.
+ */
+template<class T>
+inline void Heap<T>::popBottomUp(){
+    T last = std::move(elements[count]);
+    int lastPosition = count - 1;
+    int hole = 0;
+
+    while(true){
+        int leftChild = hole*2 + 1;
+        int rightChild = hole*2 + 2;
+        if(leftChild > lastPosition) break;
+
+        int smallChild = leftChild;
+        if((rightChild <= lastPosition) && !aLTb(elements[leftChild], elements[rightChild]))
+            smallChild = rightChild;
+        elements[hole] = std::move(elements[smallChild]);
+        hole = smallChild;
+    }
+
+    while(hole > 0){
+        int parent = (hole - 1)/2;
+        if(!aLTb(last, elements[parent])) break;
+        elements[hole] = std::move(elements[parent]);
+        hole = parent;
     }
+    elements[hole] = std::move(last);
 }
 
 template<class T>
@@ -516,20 +878,22 @@ inline int Heap<T>::getItem(T item){
 template<class T>
 inline void Heap<T>::removeInternalData(){
     if(this->deleteUserData != 0) deleteUserData(this); //clear users's data if they want
-    delete []elements;
+    destroyAll();
+    ::operator delete(elements);
 }
 
 template<class T>
 inline void Heap<T>::copyFrom(const Heap<T>& heap){
     capacity = heap.capacity;
-    count = heap.count;
-    elements = new T[capacity];
+    count = 0;
+    elements = allocate(capacity);
     this->comparator = heap.comparator;
     this->deleteUserData = heap.deleteUserData;
     
     //Copy items from heap:
-    for(int idx=0; idx < heap.size(); idx++){
-        this->elements[idx] = heap.elements[idx];
+    for(int idx=0; idx < heap.count; idx++){
+        new (&this->elements[idx]) T(heap.elements[idx]);
+        count++;
     }
 }
 
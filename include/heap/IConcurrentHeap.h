@@ -0,0 +1,28 @@
+/*
+ * File:   IConcurrentHeap.h
+ *
+ * Interface of the thread-safe priority queues: every method may be called
+ * from several threads at the same time. There is no peek/pop that can
+ * fail between a test and a use; tryPop does both at once.
+ */
+
+#ifndef ICONCURRENTHEAP_H
+#define ICONCURRENTHEAP_H
+#include <string>
+using namespace std;
+
+template<class T>
+class IConcurrentHeap {
+public:
+    virtual ~IConcurrentHeap(){};
+    virtual void push(T item)=0;
+    /* tryPop(item): remove an item and store it in "item", return true;
+     *      return false (item unchanged) if the queue was seen empty
+     */
+    virtual bool tryPop(T& item)=0;
+    virtual int size()=0;   //a snapshot: other threads may change it at once
+    virtual bool empty()=0;
+};
+
+
+#endif /* ICONCURRENTHEAP_H */
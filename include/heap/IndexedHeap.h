@@ -0,0 +1,500 @@
+/*
+ * File:   IndexedHeap.h
+ *
+ * IndexedHeap<T>: an addressable (min-)heap.
+ *  + push/insert hands out an integer "handle" for every item stored;
+ *    the handle stays valid until the item leaves the heap (pop,
+ *    removeHandle, heapify or clear). After that, every call with it
+ *    throws std::out_of_range: handles are never handed out twice.
+ *  + decreaseKey/increaseKey/update/removeHandle locate the item through
+ *    its handle in O(1) and re-heap in O(log n), instead of the linear
+ *    search done by Heap<T>::remove.
+ *
+ * Layout:
+ *  + items[slot]      : user's data, never moved while the slot is alive
+ *  + heap[pos]        : slot stored at position "pos" of the binary heap;
+ *                       heap[0..count-1] are alive, the next "released"
+ *                       ones are slots freed earlier and ready to be reused
+ *  + position[slot]   : index of "slot" inside heap[]
+ *  + generation[slot] : how many times the slot was released
+ *  Only the (int) slots move while re-heaping, never the items.
+ *  A handle is (generation << SLOT_BITS) | slot: releasing a slot makes
+ *  the handles already issued for it stale. A slot whose generation would
+ *  overflow is retired (never reused) instead of wrapping around.
+ */
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include "heap/IHeap.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ *
+ * function pointer: void (*deleteUserData)(IndexedHeap<T>* pHeap)
+ *      remove user's data in case that T is a pointer type
+ *      Users should pass &IndexedHeap<T>::free for "deleteUserData"
+ */
+template<class T>
+class IndexedHeap: public IHeap<T>{
+protected:
+    static const int SLOT_BITS = 24;
+    static const int MAX_GENERATION = (1 << (31 - SLOT_BITS)) - 1;
+
+    T *items;       //items addressed by slot
+    int *heap;      //heap of slots
+    int *position;  //position of every slot inside heap
+    int *generation;//generation of every slot, MAX_GENERATION + 1 once retired
+    int capacity;   //size of the four arrays above
+    int count;      //current count of elements stored in this heap
+    int released;   //slots in heap[count..count+released-1], ready to be reused
+    int used;       //number of slots issued so far (alive + released + retired)
+    int (*comparator)(T& lhs, T& rhs);
+    void (*deleteUserData)(IndexedHeap<T>* pHeap);
+
+public:
+    IndexedHeap(    int (*comparator)(T& , T&)=0,
+                    void (*deleteUserData)(IndexedHeap<T>*)=0 );
+    IndexedHeap(const IndexedHeap<T>& heap);
+    IndexedHeap<T>& operator=(const IndexedHeap<T>& heap);
+    ~IndexedHeap();
+
+    //Inherit from IHeap: BEGIN
+    void push(T item);
+    T pop();
+    const T peek();
+    void remove(T item, void (*removeItemData)(T)=0);
+    bool contains(T item);
+    int size();
+    void heapify(T array[], int size);
+    void clear();
+    bool empty();
+    string toString(string (*item2str)(T&)=0 );
+    //Inherit from IHeap: END
+
+    /* insert(T item): same as push, but return the handle of the new item;
+     *      throw std::length_error when no handle is left
+     */
+    int insert(T item);
+    /* peekHandle(): handle of the item at the top of the heap */
+    int peekHandle();
+    /* get(int handle): reference to the item owned by "handle"
+     *      do not change its priority through this reference without
+     *      calling update(handle) afterwards
+     */
+    T& get(int handle);
+    /* containsHandle(int handle): true if "handle" refers to an item in the heap */
+    bool containsHandle(int handle);
+    /* decreaseKey: replace the item by one that comes earlier (or equal)
+     *      in the heap order; throw std::invalid_argument otherwise
+     */
+    void decreaseKey(int handle, T item);
+    /* increaseKey: replace the item by one that comes later (or equal)
+     *      in the heap order; throw std::invalid_argument otherwise
+     */
+    void increaseKey(int handle, T item);
+    /* update: replace the item (or re-position the current one, after its
+     *      priority was changed in place) in either direction
+     */
+    void update(int handle, T item);
+    void update(int handle);
+    /* removeHandle: remove the item owned by "handle" and return it */
+    T removeHandle(int handle);
+
+    void println(string (*item2str)(T&)=0 ){
+        cout << toString(item2str) << endl;
+    }
+
+public:
+    /* if T is pointer type:
+     *     pass the address of method "free" to IndexedHeap<T>'s constructor
+     * Example:
+     *  IndexedHeap<Point*> heap(&myComparator, &IndexedHeap<Point*>::free);
+     */
+    static void free(IndexedHeap<T> *pHeap){
+        for(int pos=0; pos < pHeap->count; pos++) delete pHeap->items[pHeap->heap[pos]];
+    }
+
+private:
+    bool aLTb(T& a, T& b){
+        return compare(a, b) < 0;
+    }
+    int compare(T& a, T& b){
+        if(comparator != 0) return comparator(a, b);
+        else{
+            if (a < b) return -1;
+            else if(a > b) return 1;
+            else return 0;
+        }
+    }
+
+    int slotOf(int handle);
+    int handleOf(int slot){
+        return (generation[slot] << SLOT_BITS) | slot;
+    }
+    int takeSlot();
+    void releaseAll();
+    void ensureCapacity(int minCapacity);
+    void place(int pos, int slot);
+    void reheapUp(int pos);
+    void reheapDown(int pos);
+    void removeInternalData();
+    void copyFrom(const IndexedHeap<T>& heap);
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline IndexedHeap<T>::IndexedHeap(
+        int (*comparator)(T&, T&),
+        void (*deleteUserData)(IndexedHeap<T>* ) ){
+    capacity = 10;
+    count = 0;
+    released = 0;
+    used = 0;
+    items = new T[capacity];
+    heap = new int[capacity];
+    position = new int[capacity];
+    generation = new int[capacity];
+    this->comparator = comparator;
+    this->deleteUserData = deleteUserData;
+}
+
+template<class T>
+inline IndexedHeap<T>::IndexedHeap(const IndexedHeap<T>& heap){
+    copyFrom(heap);
+}
+
+template<class T>
+inline IndexedHeap<T>& IndexedHeap<T>::operator=(const IndexedHeap<T>& heap){
+    if(this != &heap){
+        removeInternalData();
+        copyFrom(heap);
+    }
+    return *this;
+}
+
+template<class T>
+inline IndexedHeap<T>::~IndexedHeap(){
+    removeInternalData();
+    comparator = nullptr;
+    deleteUserData = nullptr;
+}
+
+template<class T>
+inline void IndexedHeap<T>::push(T item){
+    insert(item);
+}
+
+template<class T>
+inline int IndexedHeap<T>::insert(T item){
+    int slot = takeSlot();
+    items[slot] = item;
+    count += 1;
+    reheapUp(count - 1);
+    return handleOf(slot);
+}
+
+template<class T>
+inline T IndexedHeap<T>::pop(){
+    if(count == 0)
+        throw std::underflow_error("Calling to pop with the empty heap.");
+    return removeHandle(handleOf(heap[0]));
+}
+
+template<class T>
+inline const T IndexedHeap<T>::peek(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    return items[heap[0]];
+}
+
+template<class T>
+inline int IndexedHeap<T>::peekHandle(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    return handleOf(heap[0]);
+}
+
+template<class T>
+inline void IndexedHeap<T>::remove(T item, void (*removeItemData)(T)){
+    for(int pos=0; pos < count; pos++){
+        if(compare(items[heap[pos]], item) == 0){
+            removeHandle(handleOf(heap[pos]));
+            if(removeItemData != 0) removeItemData(item);
+            return;
+        }
+    }
+}
+
+template<class T>
+inline bool IndexedHeap<T>::contains(T item){
+    for(int pos=0; pos < count; pos++){
+        if(compare(items[heap[pos]], item) == 0) return true;
+    }
+    return false;
+}
+
+template<class T>
+inline int IndexedHeap<T>::size(){
+    return count;
+}
+
+/*
+ * heapify: replace the content of the heap by array[0..size-1], as
+ *      Heap<T>::heapify does; the handles of the previous items go stale.
+ */
+template<class T>
+inline void IndexedHeap<T>::heapify(T array[], int size){
+    clear();
+    for(int idx=0; idx < size; idx++){
+        int slot = takeSlot();
+        items[slot] = array[idx];
+        count += 1;
+    }
+    for(int pos = count/2 - 1; pos >= 0; pos--) reheapDown(pos);
+}
+
+/*
+ * clear: the slots are released, not forgotten, so that the handles issued
+ *      before clear() stay stale after it.
+ */
+template<class T>
+inline void IndexedHeap<T>::clear(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    releaseAll();
+}
+
+template<class T>
+inline bool IndexedHeap<T>::empty(){
+    return count == 0;
+}
+
+template<class T>
+inline string IndexedHeap<T>::toString(string (*item2str)(T&)){
+    stringstream os;
+    os << "[";
+    for(int pos=0; pos < count; pos++){
+        if(pos > 0) os << ",";
+        if(item2str != 0) os << item2str(items[heap[pos]]);
+        else os << items[heap[pos]];
+    }
+    os << "]";
+    return os.str();
+}
+
+template<class T>
+inline T& IndexedHeap<T>::get(int handle){
+    return items[slotOf(handle)];
+}
+
+template<class T>
+inline bool IndexedHeap<T>::containsHandle(int handle){
+    if(handle < 0) return false;
+    int slot = handle & ((1 << SLOT_BITS) - 1);
+    return (slot < used) && (generation[slot] == (handle >> SLOT_BITS)) && (position[slot] < count);
+}
+
+template<class T>
+inline void IndexedHeap<T>::decreaseKey(int handle, T item){
+    int slot = slotOf(handle);
+    if(aLTb(items[slot], item))
+        throw std::invalid_argument("decreaseKey: new item comes later than the current one.");
+    items[slot] = item;
+    reheapUp(position[slot]);
+}
+
+template<class T>
+inline void IndexedHeap<T>::increaseKey(int handle, T item){
+    int slot = slotOf(handle);
+    if(aLTb(item, items[slot]))
+        throw std::invalid_argument("increaseKey: new item comes earlier than the current one.");
+    items[slot] = item;
+    reheapDown(position[slot]);
+}
+
+template<class T>
+inline void IndexedHeap<T>::update(int handle, T item){
+    items[slotOf(handle)] = item;
+    update(handle);
+}
+
+template<class T>
+inline void IndexedHeap<T>::update(int handle){
+    int slot = slotOf(handle);
+    int pos = position[slot];
+    reheapUp(pos);
+    if(heap[pos] == slot) reheapDown(pos); //did not move up => may need to go down
+}
+
+template<class T>
+inline T IndexedHeap<T>::removeHandle(int handle){
+    int slot = slotOf(handle);
+    T item = items[slot];
+    int pos = position[slot];
+    int last = count - 1;
+
+    //move the last alive slot into the hole; the removed one goes to "last",
+    //the head of the released slots, unless it is retired
+    int moved = heap[last];
+    place(pos, moved);
+    count -= 1;
+    generation[slot] += 1;
+    if(generation[slot] <= MAX_GENERATION){
+        place(last, slot);
+        released += 1;
+    }
+    else if(released > 0) place(last, heap[last + released]);
+
+    if(pos < count){
+        reheapUp(pos);
+        if(heap[pos] == moved) reheapDown(pos);
+    }
+    return item;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline int IndexedHeap<T>::slotOf(int handle){
+    if(!containsHandle(handle))
+        throw std::out_of_range("Handle is invalid!");
+    return handle & ((1 << SLOT_BITS) - 1);
+}
+
+/* takeSlot: a slot for a new item, placed at heap[count] (count not updated) */
+template<class T>
+inline int IndexedHeap<T>::takeSlot(){
+    if(released > 0){
+        released -= 1;
+        return heap[count]; //reuse a released slot, already at heap[count]
+    }
+    if(used == (1 << SLOT_BITS))
+        throw std::length_error("IndexedHeap: no handle left.");
+    ensureCapacity(used + 1);
+    int slot = used++;
+    generation[slot] = 0;
+    place(count, slot);
+    return slot;
+}
+
+/* releaseAll: release every alive slot; the heap becomes empty */
+template<class T>
+inline void IndexedHeap<T>::releaseAll(){
+    int kept = 0;
+    for(int pos=0; pos < count + released; pos++){
+        int slot = heap[pos];
+        if(pos < count){
+            generation[slot] += 1;
+            if(generation[slot] > MAX_GENERATION) continue; //retired
+        }
+        place(kept++, slot);
+    }
+    count = 0;
+    released = kept;
+}
+
+template<class T>
+inline void IndexedHeap<T>::ensureCapacity(int minCapacity){
+    if(minCapacity <= capacity) return;
+
+    int newCapacity = capacity * 2;
+    if(newCapacity < minCapacity) newCapacity = minCapacity;
+
+    T* newItems = new T[newCapacity];
+    int* newHeap = new int[newCapacity];
+    int* newPosition = new int[newCapacity];
+    int* newGeneration = new int[newCapacity];
+    for(int idx=0; idx < used; idx++){
+        newItems[idx] = items[idx];
+        newHeap[idx] = heap[idx];
+        newPosition[idx] = position[idx];
+        newGeneration[idx] = generation[idx];
+    }
+    delete []items;
+    delete []heap;
+    delete []position;
+    delete []generation;
+    items = newItems;
+    heap = newHeap;
+    position = newPosition;
+    generation = newGeneration;
+    capacity = newCapacity;
+}
+
+template<class T>
+inline void IndexedHeap<T>::place(int pos, int slot){
+    heap[pos] = slot;
+    position[slot] = pos;
+}
+
+template<class T>
+inline void IndexedHeap<T>::reheapUp(int pos){
+    int slot = heap[pos];
+    while(pos > 0){
+        int parent = (pos - 1)/2;
+        if(!aLTb(items[slot], items[heap[parent]])) break;
+        place(pos, heap[parent]);
+        pos = parent;
+    }
+    place(pos, slot);
+}
+
+template<class T>
+inline void IndexedHeap<T>::reheapDown(int pos){
+    int slot = heap[pos];
+    int lastPosition = count - 1;
+    while(true){
+        int child = pos*2 + 1;
+        if(child > lastPosition) break;
+        if((child + 1 <= lastPosition) && aLTb(items[heap[child + 1]], items[heap[child]]))
+            child += 1;
+        if(!aLTb(items[heap[child]], items[slot])) break;
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, slot);
+}
+
+template<class T>
+inline void IndexedHeap<T>::removeInternalData(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    delete []items;
+    delete []heap;
+    delete []position;
+    delete []generation;
+}
+
+template<class T>
+inline void IndexedHeap<T>::copyFrom(const IndexedHeap<T>& heap){
+    capacity = heap.capacity;
+    count = heap.count;
+    released = heap.released;
+    used = heap.used;
+    items = new T[capacity];
+    this->heap = new int[capacity];
+    position = new int[capacity];
+    generation = new int[capacity];
+    this->comparator = heap.comparator;
+    this->deleteUserData = heap.deleteUserData;
+
+    for(int idx=0; idx < used; idx++){
+        items[idx] = heap.items[idx];
+        this->heap[idx] = heap.heap[idx];
+        position[idx] = heap.position[idx];
+        generation[idx] = heap.generation[idx];
+    }
+}
+
+#endif /* INDEXEDHEAP_H */
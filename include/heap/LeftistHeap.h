@@ -0,0 +1,356 @@
+/*
+ * File:   LeftistHeap.h
+ *
+ * LeftistHeap<T>: a mergeable (min-)heap stored as a binary tree where the
+ *  "rank" (length of the right spine) of a left child is never smaller than
+ *  that of its right sibling. The right spine therefore has O(log n) nodes
+ *  and every operation walks only right spines.
+ *  + meld, push, pop : O(log n) worst case
+ *  + peek            : O(1)
+ *  + heapify         : O(n), melding singletons pairwise
+ */
+
+#ifndef LEFTISTHEAP_H
+#define LEFTISTHEAP_H
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include "heap/IHeap.h"
+#include "list/XArrayList.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ *
+ * function pointer: void (*deleteUserData)(LeftistHeap<T>* pHeap)
+ *      remove user's data in case that T is a pointer type
+ *      Users should pass &LeftistHeap<T>::free for "deleteUserData"
+ */
+template<class T>
+class LeftistHeap: public IHeap<T>{
+public:
+    class Node; //forward declaration
+
+protected:
+    Node *root;
+    int count;
+    int (*comparator)(T& lhs, T& rhs);
+    void (*deleteUserData)(LeftistHeap<T>* pHeap);
+
+public:
+    LeftistHeap(    int (*comparator)(T& , T&)=0,
+                    void (*deleteUserData)(LeftistHeap<T>*)=0 );
+    LeftistHeap(const LeftistHeap<T>& heap);
+    LeftistHeap<T>& operator=(const LeftistHeap<T>& heap);
+    ~LeftistHeap();
+
+    //Inherit from IHeap: BEGIN
+    void push(T item);
+    T pop();
+    const T peek();
+    void remove(T item, void (*removeItemData)(T)=0);
+    bool contains(T item);
+    int size();
+    void heapify(T array[], int size);
+    void clear();
+    bool empty();
+    string toString(string (*item2str)(T&)=0 );
+    //Inherit from IHeap: END
+
+    /* meld(other): move all items of "other" into this heap in O(log n);
+     *      other is left empty. Both heaps must use the same order.
+     */
+    void meld(LeftistHeap<T>& other);
+
+    void println(string (*item2str)(T&)=0 ){
+        cout << toString(item2str) << endl;
+    }
+
+public:
+    static void free(LeftistHeap<T> *pHeap){
+        XArrayList<Node*> nodes;
+        pHeap->collect(nodes);
+        for(int idx=0; idx < nodes.size(); idx++) delete nodes.get(idx)->item;
+    }
+
+private:
+    bool aLTb(T& a, T& b){
+        return compare(a, b) < 0;
+    }
+    int compare(T& a, T& b){
+        if(comparator != 0) return comparator(a, b);
+        else{
+            if (a < b) return -1;
+            else if(a > b) return 1;
+            else return 0;
+        }
+    }
+
+    static int rankOf(Node* node){
+        return (node == 0) ? 0 : node->rank;
+    }
+    Node* merge(Node* a, Node* b);
+    Node* build(XArrayList<Node*>& nodes);
+    void collect(XArrayList<Node*>& nodes);
+    void removeInternalData();
+    void copyFrom(const LeftistHeap<T>& heap);
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////  INNER CLASSES DEFNITION ////////////////////
+//////////////////////////////////////////////////////////////////////
+public:
+    class Node{
+    public:
+        T item;
+        int rank;   //number of nodes on the right spine of this subtree
+        Node* left;
+        Node* right;
+        Node(T item): item(item), rank(1), left(0), right(0){}
+    };
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline LeftistHeap<T>::LeftistHeap(
+        int (*comparator)(T&, T&),
+        void (*deleteUserData)(LeftistHeap<T>* ) ){
+    root = 0;
+    count = 0;
+    this->comparator = comparator;
+    this->deleteUserData = deleteUserData;
+}
+
+template<class T>
+inline LeftistHeap<T>::LeftistHeap(const LeftistHeap<T>& heap){
+    copyFrom(heap);
+}
+
+template<class T>
+inline LeftistHeap<T>& LeftistHeap<T>::operator=(const LeftistHeap<T>& heap){
+    if(this != &heap){
+        removeInternalData();
+        copyFrom(heap);
+    }
+    return *this;
+}
+
+template<class T>
+inline LeftistHeap<T>::~LeftistHeap(){
+    removeInternalData();
+    comparator = nullptr;
+    deleteUserData = nullptr;
+}
+
+template<class T>
+inline void LeftistHeap<T>::push(T item){
+    root = merge(root, new Node(item));
+    count += 1;
+}
+
+template<class T>
+inline T LeftistHeap<T>::pop(){
+    if(count == 0)
+        throw std::underflow_error("Calling to pop with the empty heap.");
+
+    Node* oldRoot = root;
+    T item = oldRoot->item;
+    root = merge(oldRoot->left, oldRoot->right);
+    delete oldRoot;
+    count -= 1;
+    return item;
+}
+
+template<class T>
+inline const T LeftistHeap<T>::peek(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    return root->item;
+}
+
+/*
+ * remove: the item is searched for (O(n), like Heap<T>::remove) and the
+ *      remaining nodes are rebuilt in O(n).
+ */
+template<class T>
+inline void LeftistHeap<T>::remove(T item, void (*removeItemData)(T)){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+
+    int foundIdx = -1;
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(compare(nodes.get(idx)->item, item) == 0){
+            foundIdx = idx;
+            break;
+        }
+    }
+    if(foundIdx == -1) return;
+
+    delete nodes.removeAt(foundIdx);
+    root = build(nodes);
+    count -= 1;
+    if(removeItemData != 0) removeItemData(item);
+}
+
+template<class T>
+inline bool LeftistHeap<T>::contains(T item){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(compare(nodes.get(idx)->item, item) == 0) return true;
+    }
+    return false;
+}
+
+template<class T>
+inline int LeftistHeap<T>::size(){
+    return count;
+}
+
+template<class T>
+inline void LeftistHeap<T>::heapify(T array[], int size){
+    clear();
+    XArrayList<Node*> nodes;
+    for(int idx=0; idx < size; idx++) nodes.add(new Node(array[idx]));
+    root = build(nodes);
+    count = size;
+}
+
+template<class T>
+inline void LeftistHeap<T>::clear(){
+    removeInternalData();
+    root = 0;
+    count = 0;
+}
+
+template<class T>
+inline bool LeftistHeap<T>::empty(){
+    return count == 0;
+}
+
+/*
+ * toString: items in pre-order (root, left subtree, right subtree).
+ */
+template<class T>
+inline string LeftistHeap<T>::toString(string (*item2str)(T&)){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    stringstream os;
+    os << "[";
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(idx > 0) os << ",";
+        if(item2str != 0) os << item2str(nodes.get(idx)->item);
+        else os << nodes.get(idx)->item;
+    }
+    os << "]";
+    return os.str();
+}
+
+template<class T>
+inline void LeftistHeap<T>::meld(LeftistHeap<T>& other){
+    if(this == &other) return;
+    root = merge(root, other.root);
+    count += other.count;
+    other.root = 0;
+    other.count = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+/*
+ * merge(a, b): merge along the right spines, then swap children wherever
+ *      the leftist property is broken. Recursion depth is bounded by the
+ *      length of the two right spines, O(log n).
+ */
+template<class T>
+inline typename LeftistHeap<T>::Node* LeftistHeap<T>::merge(Node* a, Node* b){
+    if(a == 0) return b;
+    if(b == 0) return a;
+    if(aLTb(b->item, a->item)){
+        Node* temp = a;
+        a = b;
+        b = temp;
+    }
+    a->right = merge(a->right, b);
+    if(rankOf(a->left) < rankOf(a->right)){
+        Node* temp = a->left;
+        a->left = a->right;
+        a->right = temp;
+    }
+    a->rank = rankOf(a->right) + 1;
+    return a;
+}
+
+/*
+ * build: meld single-node (or detached) trees in rounds, two by two, as in
+ *      a queue => O(n) in total.
+ */
+template<class T>
+inline typename LeftistHeap<T>::Node* LeftistHeap<T>::build(XArrayList<Node*>& nodes){
+    if(nodes.size() == 0) return 0;
+    for(int idx=0; idx < nodes.size(); idx++){
+        Node* node = nodes.get(idx);
+        node->left = node->right = 0;
+        node->rank = 1;
+    }
+
+    int head = 0;
+    while(nodes.size() - head > 1){
+        Node* a = nodes.get(head);
+        Node* b = nodes.get(head + 1);
+        head += 2;
+        nodes.add(merge(a, b));
+    }
+    return nodes.get(head);
+}
+
+/*
+ * collect: all nodes in pre-order, without recursion.
+ */
+template<class T>
+inline void LeftistHeap<T>::collect(XArrayList<Node*>& nodes){
+    if(root == 0) return;
+    XArrayList<Node*> stack;
+    stack.add(root);
+    while(!stack.empty()){
+        Node* node = stack.removeAt(stack.size() - 1);
+        nodes.add(node);
+        if(node->right != 0) stack.add(node->right);
+        if(node->left != 0) stack.add(node->left);
+    }
+}
+
+template<class T>
+inline void LeftistHeap<T>::removeInternalData(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    for(int idx=0; idx < nodes.size(); idx++) delete nodes.get(idx);
+    root = 0;
+    count = 0;
+}
+
+template<class T>
+inline void LeftistHeap<T>::copyFrom(const LeftistHeap<T>& heap){
+    root = 0;
+    count = 0;
+    this->comparator = heap.comparator;
+    this->deleteUserData = heap.deleteUserData;
+
+    XArrayList<Node*> nodes;
+    const_cast<LeftistHeap<T>&>(heap).collect(nodes);
+    XArrayList<Node*> copies;
+    for(int idx=0; idx < nodes.size(); idx++) copies.add(new Node(nodes.get(idx)->item));
+    root = build(copies);
+    count = nodes.size();
+}
+
+#endif /* LEFTISTHEAP_H */
@@ -0,0 +1,219 @@
+/*
+ * File:   MultiQueue.h
+ *
+ * MultiQueue<T>: a relaxed concurrent priority queue.
+ *  + the items are spread over c*p sequential heaps (p: number of threads,
+ *    c: a small factor), each one with its own lock;
+ *  + push puts the item in a random heap;
+ *  + tryPop looks at the tops of two random heaps and pops the better one.
+ *  Threads rarely wait for each other, so throughput grows with the number
+ *  of threads. In exchange tryPop returns "one of the smallest" items
+ *  rather than the smallest: the expected rank of a popped item is O(c*p).
+ *  Use ConcurrentHeap<T> where strict ordering matters.
+ */
+
+#ifndef MULTIQUEUE_H
+#define MULTIQUEUE_H
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include "heap/IConcurrentHeap.h"
+#include "heap/Heap.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ * Items still in the queue are not deleted by the destructor.
+ */
+template<class T>
+class MultiQueue: public IConcurrentHeap<T>{
+public:
+    class SubQueue; //forward declaration
+
+protected:
+    SubQueue *queues;   //array of numQueues heaps
+    int numQueues;
+    atomic<int> count;
+    int (*comparator)(T& lhs, T& rhs);
+
+public:
+    /* numThreads: expected number of threads using the queue (0: hardware)
+     * factor    : heaps per thread (c); larger => less contention, looser order
+     */
+    MultiQueue( int (*comparator)(T& , T&)=0,
+                int numThreads=0,
+                int factor=2 );
+    MultiQueue(const MultiQueue<T>& queue) = delete;
+    MultiQueue<T>& operator=(const MultiQueue<T>& queue) = delete;
+    ~MultiQueue();
+
+    //Inherit from IConcurrentHeap: BEGIN
+    void push(T item);
+    bool tryPop(T& item);
+    int size();
+    bool empty();
+    //Inherit from IConcurrentHeap: END
+
+    int queueCount(){
+        return numQueues;
+    }
+
+private:
+    int compare(T& a, T& b){
+        if(comparator != 0) return comparator(a, b);
+        else{
+            if (a < b) return -1;
+            else if(a > b) return 1;
+            else return 0;
+        }
+    }
+    static unsigned int randomIndex(int bound);
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////  INNER CLASSES DEFNITION ////////////////////
+//////////////////////////////////////////////////////////////////////
+public:
+    //one heap + its lock, on its own cache line(s) to avoid false sharing
+    class alignas(64) SubQueue{
+    public:
+        mutex lock;
+        Heap<T>* heap;
+        SubQueue(): heap(0){}
+        ~SubQueue(){ delete heap; }
+    };
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline MultiQueue<T>::MultiQueue(
+        int (*comparator)(T&, T&),
+        int numThreads,
+        int factor ){
+    if(numThreads <= 0) numThreads = thread::hardware_concurrency();
+    if(numThreads <= 0) numThreads = 1;
+    if(factor <= 0) factor = 1;
+
+    this->comparator = comparator;
+    numQueues = numThreads*factor;
+    if(numQueues < 2) numQueues = 2;
+    queues = new SubQueue[numQueues];
+    for(int idx=0; idx < numQueues; idx++) queues[idx].heap = new Heap<T>(comparator);
+    count = 0;
+}
+
+template<class T>
+inline MultiQueue<T>::~MultiQueue(){
+    delete []queues;
+}
+
+template<class T>
+inline void MultiQueue<T>::push(T item){
+    while(true){
+        SubQueue& queue = queues[randomIndex(numQueues)];
+        if(queue.lock.try_lock()){
+            queue.heap->push(std::move(item));
+            count.fetch_add(1);
+            queue.lock.unlock();
+            return;
+        }
+    }
+}
+
+/*
+ * tryPop:
+ *  (1) a few rounds of "two random choices": lock two heaps (try_lock,
+ *      never wait), pop from the one whose top comes first;
+ *  (2) if the queue still looks non-empty, scan the heaps in turn, so an
+ *      item is never missed when only a few heaps hold items. The scan
+ *      uses try_lock too: a busy heap is skipped and visited again on the
+ *      next lap, until an item is popped or the queue is empty.
+ */
+template<class T>
+inline bool MultiQueue<T>::tryPop(T& item){
+    const int ROUNDS = 8;
+    for(int round=0; round < ROUNDS; round++){
+        if(count.load() == 0) return false;
+
+        int first = randomIndex(numQueues);
+        int second = randomIndex(numQueues - 1);
+        if(second >= first) second += 1;
+        if(second < first){
+            int temp = first;
+            first = second;
+            second = temp;
+        }
+
+        SubQueue& a = queues[first];
+        SubQueue& b = queues[second];
+        if(!a.lock.try_lock()) continue;
+        if(!b.lock.try_lock()){
+            a.lock.unlock();
+            continue;
+        }
+
+        Heap<T>* from = 0;
+        if(!a.heap->empty() && !b.heap->empty()){
+            T topA = a.heap->peek();
+            T topB = b.heap->peek();
+            from = (compare(topB, topA) < 0) ? b.heap : a.heap;
+        }
+        else if(!a.heap->empty()) from = a.heap;
+        else if(!b.heap->empty()) from = b.heap;
+
+        if(from != 0){
+            item = from->pop();
+            count.fetch_sub(1);
+        }
+        b.lock.unlock();
+        a.lock.unlock();
+        if(from != 0) return true;
+    }
+
+    for(int index = randomIndex(numQueues); count.load() > 0; index = (index + 1) % numQueues){
+        SubQueue& queue = queues[index];
+        if(!queue.lock.try_lock()) continue;
+        bool found = !queue.heap->empty();
+        if(found){
+            item = queue.heap->pop();
+            count.fetch_sub(1);
+        }
+        queue.lock.unlock();
+        if(found) return true;
+    }
+    return false;
+}
+
+template<class T>
+inline int MultiQueue<T>::size(){
+    return count.load();
+}
+
+template<class T>
+inline bool MultiQueue<T>::empty(){
+    return count.load() == 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline unsigned int MultiQueue<T>::randomIndex(int bound){
+    //xorshift, one state per thread: no shared state between threads
+    thread_local unsigned int state =
+        (unsigned int)hash<thread::id>()(this_thread::get_id()) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % (unsigned int)bound;
+}
+
+#endif /* MULTIQUEUE_H */
@@ -0,0 +1,358 @@
+/*
+ * File:   PairingHeap.h
+ *
+ * PairingHeap<T>: a mergeable (min-)heap stored as a multi-way tree.
+ *  + push, peek, meld : O(1)
+ *  + pop              : O(log n) amortized (two-pass pairing of the
+ *                       root's children)
+ *  Every node keeps its first child and its next sibling, so the children
+ *  of a node form a singly linked list.
+ */
+
+#ifndef PAIRINGHEAP_H
+#define PAIRINGHEAP_H
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include "heap/IHeap.h"
+#include "list/XArrayList.h"
+
+using namespace std;
+
+/*
+ * function pointer: int (*comparator)(T& lhs, T& rhs)
+ *      same convention as Heap<T>: return sign of (lhs - rhs)
+ *
+ * function pointer: void (*deleteUserData)(PairingHeap<T>* pHeap)
+ *      remove user's data in case that T is a pointer type
+ *      Users should pass &PairingHeap<T>::free for "deleteUserData"
+ */
+template<class T>
+class PairingHeap: public IHeap<T>{
+public:
+    class Node; //forward declaration
+
+protected:
+    Node *root;
+    int count;
+    int (*comparator)(T& lhs, T& rhs);
+    void (*deleteUserData)(PairingHeap<T>* pHeap);
+
+public:
+    PairingHeap(    int (*comparator)(T& , T&)=0,
+                    void (*deleteUserData)(PairingHeap<T>*)=0 );
+    PairingHeap(const PairingHeap<T>& heap);
+    PairingHeap<T>& operator=(const PairingHeap<T>& heap);
+    ~PairingHeap();
+
+    //Inherit from IHeap: BEGIN
+    void push(T item);
+    T pop();
+    const T peek();
+    void remove(T item, void (*removeItemData)(T)=0);
+    bool contains(T item);
+    int size();
+    void heapify(T array[], int size);
+    void clear();
+    bool empty();
+    string toString(string (*item2str)(T&)=0 );
+    //Inherit from IHeap: END
+
+    /* meld(other): move all items of "other" into this heap in O(1);
+     *      other is left empty. Both heaps must use the same order.
+     */
+    void meld(PairingHeap<T>& other);
+
+    void println(string (*item2str)(T&)=0 ){
+        cout << toString(item2str) << endl;
+    }
+
+public:
+    static void free(PairingHeap<T> *pHeap){
+        XArrayList<Node*> nodes;
+        pHeap->collect(nodes);
+        for(int idx=0; idx < nodes.size(); idx++) delete nodes.get(idx)->item;
+    }
+
+private:
+    bool aLTb(T& a, T& b){
+        return compare(a, b) < 0;
+    }
+    int compare(T& a, T& b){
+        if(comparator != 0) return comparator(a, b);
+        else{
+            if (a < b) return -1;
+            else if(a > b) return 1;
+            else return 0;
+        }
+    }
+
+    Node* link(Node* a, Node* b);
+    Node* mergePairs(Node* first);
+    void collect(XArrayList<Node*>& nodes);
+    void removeInternalData();
+    void copyFrom(const PairingHeap<T>& heap);
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////  INNER CLASSES DEFNITION ////////////////////
+//////////////////////////////////////////////////////////////////////
+public:
+    class Node{
+    public:
+        T item;
+        Node* child;    //first child
+        Node* sibling;  //next sibling
+        Node(T item): item(item), child(0), sibling(0){}
+    };
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline PairingHeap<T>::PairingHeap(
+        int (*comparator)(T&, T&),
+        void (*deleteUserData)(PairingHeap<T>* ) ){
+    root = 0;
+    count = 0;
+    this->comparator = comparator;
+    this->deleteUserData = deleteUserData;
+}
+
+template<class T>
+inline PairingHeap<T>::PairingHeap(const PairingHeap<T>& heap){
+    copyFrom(heap);
+}
+
+template<class T>
+inline PairingHeap<T>& PairingHeap<T>::operator=(const PairingHeap<T>& heap){
+    if(this != &heap){
+        removeInternalData();
+        copyFrom(heap);
+    }
+    return *this;
+}
+
+template<class T>
+inline PairingHeap<T>::~PairingHeap(){
+    removeInternalData();
+    comparator = nullptr;
+    deleteUserData = nullptr;
+}
+
+template<class T>
+inline void PairingHeap<T>::push(T item){
+    root = link(root, new Node(item));
+    count += 1;
+}
+
+template<class T>
+inline T PairingHeap<T>::pop(){
+    if(count == 0)
+        throw std::underflow_error("Calling to pop with the empty heap.");
+
+    Node* oldRoot = root;
+    T item = oldRoot->item;
+    root = mergePairs(oldRoot->child);
+    delete oldRoot;
+    count -= 1;
+    return item;
+}
+
+template<class T>
+inline const T PairingHeap<T>::peek(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    return root->item;
+}
+
+/*
+ * remove: nodes carry no parent link, so the item is searched for and the
+ *      remaining nodes are re-linked (O(n), like Heap<T>::remove).
+ */
+template<class T>
+inline void PairingHeap<T>::remove(T item, void (*removeItemData)(T)){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+
+    int foundIdx = -1;
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(compare(nodes.get(idx)->item, item) == 0){
+            foundIdx = idx;
+            break;
+        }
+    }
+    if(foundIdx == -1) return;
+
+    delete nodes.get(foundIdx);
+    root = 0;
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(idx == foundIdx) continue;
+        Node* node = nodes.get(idx);
+        node->child = node->sibling = 0;
+        root = link(root, node);
+    }
+    count -= 1;
+    if(removeItemData != 0) removeItemData(item);
+}
+
+template<class T>
+inline bool PairingHeap<T>::contains(T item){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(compare(nodes.get(idx)->item, item) == 0) return true;
+    }
+    return false;
+}
+
+template<class T>
+inline int PairingHeap<T>::size(){
+    return count;
+}
+
+template<class T>
+inline void PairingHeap<T>::heapify(T array[], int size){
+    clear();
+    for(int idx=0; idx < size; idx++) push(array[idx]);
+}
+
+template<class T>
+inline void PairingHeap<T>::clear(){
+    removeInternalData();
+    root = 0;
+    count = 0;
+}
+
+template<class T>
+inline bool PairingHeap<T>::empty(){
+    return count == 0;
+}
+
+/*
+ * toString: items in pre-order (root first, then each subtree of its
+ *      children from left to right).
+ */
+template<class T>
+inline string PairingHeap<T>::toString(string (*item2str)(T&)){
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    stringstream os;
+    os << "[";
+    for(int idx=0; idx < nodes.size(); idx++){
+        if(idx > 0) os << ",";
+        if(item2str != 0) os << item2str(nodes.get(idx)->item);
+        else os << nodes.get(idx)->item;
+    }
+    os << "]";
+    return os.str();
+}
+
+template<class T>
+inline void PairingHeap<T>::meld(PairingHeap<T>& other){
+    if(this == &other) return;
+    root = link(root, other.root);
+    count += other.count;
+    other.root = 0;
+    other.count = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+/*
+ * link(a, b): the root with the larger item becomes the first child of the
+ *      other one. a and b must be roots (no sibling).
+ */
+template<class T>
+inline typename PairingHeap<T>::Node* PairingHeap<T>::link(Node* a, Node* b){
+    if(a == 0) return b;
+    if(b == 0) return a;
+    if(aLTb(b->item, a->item)){
+        Node* temp = a;
+        a = b;
+        b = temp;
+    }
+    b->sibling = a->child;
+    a->child = b;
+    return a;
+}
+
+/*
+ * mergePairs: two-pass pairing of a sibling list.
+ *  (1) left to right: link siblings two by two, pushing every pair on a
+ *      stack (reusing the sibling pointers);
+ *  (2) right to left: link the pairs into a single tree.
+ */
+template<class T>
+inline typename PairingHeap<T>::Node* PairingHeap<T>::mergePairs(Node* first){
+    Node* pairs = 0; //stack of linked pairs, chained through "sibling"
+    while(first != 0){
+        Node* a = first;
+        Node* b = a->sibling;
+        if(b == 0){
+            first = 0;
+        }
+        else{
+            first = b->sibling;
+            b->sibling = 0;
+        }
+        a->sibling = 0;
+        Node* pair = link(a, b);
+        pair->sibling = pairs;
+        pairs = pair;
+    }
+
+    Node* result = 0;
+    while(pairs != 0){
+        Node* next = pairs->sibling;
+        pairs->sibling = 0;
+        result = link(pairs, result);
+        pairs = next;
+    }
+    return result;
+}
+
+/*
+ * collect: all nodes in pre-order, without recursion.
+ */
+template<class T>
+inline void PairingHeap<T>::collect(XArrayList<Node*>& nodes){
+    if(root == 0) return;
+    XArrayList<Node*> stack;
+    stack.add(root);
+    while(!stack.empty()){
+        Node* node = stack.removeAt(stack.size() - 1);
+        nodes.add(node);
+        if(node->sibling != 0) stack.add(node->sibling);
+        if(node->child != 0) stack.add(node->child);
+    }
+}
+
+template<class T>
+inline void PairingHeap<T>::removeInternalData(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    XArrayList<Node*> nodes;
+    collect(nodes);
+    for(int idx=0; idx < nodes.size(); idx++) delete nodes.get(idx);
+    root = 0;
+    count = 0;
+}
+
+template<class T>
+inline void PairingHeap<T>::copyFrom(const PairingHeap<T>& heap){
+    root = 0;
+    count = 0;
+    this->comparator = heap.comparator;
+    this->deleteUserData = heap.deleteUserData;
+
+    XArrayList<Node*> nodes;
+    const_cast<PairingHeap<T>&>(heap).collect(nodes);
+    for(int idx=0; idx < nodes.size(); idx++) push(nodes.get(idx)->item);
+}
+
+#endif /* PAIRINGHEAP_H */
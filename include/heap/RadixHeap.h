@@ -0,0 +1,311 @@
+/*
+ * File:   RadixHeap.h
+ *
+ * RadixHeap<T>: a monotone priority queue for items with non-negative
+ *  integer keys (frequencies, days, distances, ...).
+ *  + keyOf(item) gives the key of an item; pop returns an item with the
+ *    smallest key.
+ *  + monotone: a pushed key must not be smaller than the key of the last
+ *    item returned by pop or peek (true for Huffman merging, Dijkstra,
+ *    event scheduling); push throws std::invalid_argument otherwise.
+ *
+ * Buckets: bucket 0 holds the items whose key equals "last" (the last
+ *  popped key); bucket b > 0 holds the keys whose highest bit differing
+ *  from "last" is bit b-1. When bucket 0 is empty, the first non-empty
+ *  bucket is scanned for its minimum, which becomes "last", and its items
+ *  are spread over lower buckets. An item only moves to lower buckets, so
+ *  push is O(1) and pop is O(log C) amortized (C: largest key), with no
+ *  comparison between items.
+ */
+
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include "heap/IHeap.h"
+#include "list/XArrayList.h"
+
+using namespace std;
+
+/*
+ * function pointer: long long (*keyOf)(T& item)
+ *      return the (non-negative) priority of item; smaller comes first.
+ *      Two items are "equal" for remove/contains when their keys are equal,
+ *      as Heap<T> treats compare() == 0.
+ *
+ * function pointer: void (*deleteUserData)(RadixHeap<T>* pHeap)
+ *      remove user's data in case that T is a pointer type
+ *      Users should pass &RadixHeap<T>::free for "deleteUserData"
+ */
+template<class T>
+class RadixHeap: public IHeap<T>{
+public:
+    class Entry; //forward declaration
+    static const int NUM_BUCKETS = 65; //bucket 0 + one per bit of the key
+
+protected:
+    XArrayList<Entry>* buckets[NUM_BUCKETS];
+    long long last;     //key of the last popped/peeked item (0 at the beginning)
+    int count;
+    long long (*keyOf)(T& item);
+    void (*deleteUserData)(RadixHeap<T>* pHeap);
+
+public:
+    RadixHeap(  long long (*keyOf)(T&),
+                void (*deleteUserData)(RadixHeap<T>*)=0 );
+    RadixHeap(const RadixHeap<T>& heap);
+    RadixHeap<T>& operator=(const RadixHeap<T>& heap);
+    ~RadixHeap();
+
+    //Inherit from IHeap: BEGIN
+    void push(T item);
+    T pop();
+    const T peek();
+    void remove(T item, void (*removeItemData)(T)=0);
+    bool contains(T item);
+    int size();
+    void heapify(T array[], int size);
+    void clear();
+    bool empty();
+    string toString(string (*item2str)(T&)=0 );
+    //Inherit from IHeap: END
+
+    void println(string (*item2str)(T&)=0 ){
+        cout << toString(item2str) << endl;
+    }
+
+public:
+    static void free(RadixHeap<T> *pHeap){
+        for(int b=0; b < NUM_BUCKETS; b++){
+            XArrayList<Entry>* bucket = pHeap->buckets[b];
+            for(int idx=0; idx < bucket->size(); idx++) delete bucket->get(idx).item;
+        }
+    }
+
+private:
+    int bucketOf(long long key);
+    void refill();
+    void allocateBuckets();
+    void removeInternalData();
+    void copyFrom(const RadixHeap<T>& heap);
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////  INNER CLASSES DEFNITION ////////////////////
+//////////////////////////////////////////////////////////////////////
+public:
+    class Entry{
+    public:
+        long long key;
+        T item;
+        Entry(): key(0){}
+        Entry(long long key, T item): key(key), item(item){}
+        bool operator==(const Entry& other) const{ return key == other.key; }
+        friend ostream& operator<<(ostream& os, const Entry& entry){
+            return os << entry.key;
+        }
+    };
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline RadixHeap<T>::RadixHeap(
+        long long (*keyOf)(T&),
+        void (*deleteUserData)(RadixHeap<T>* ) ){
+    this->keyOf = keyOf;
+    this->deleteUserData = deleteUserData;
+    last = 0;
+    count = 0;
+    allocateBuckets();
+}
+
+template<class T>
+inline RadixHeap<T>::RadixHeap(const RadixHeap<T>& heap){
+    allocateBuckets();
+    copyFrom(heap);
+}
+
+template<class T>
+inline RadixHeap<T>& RadixHeap<T>::operator=(const RadixHeap<T>& heap){
+    if(this != &heap){
+        removeInternalData();
+        allocateBuckets();
+        copyFrom(heap);
+    }
+    return *this;
+}
+
+template<class T>
+inline RadixHeap<T>::~RadixHeap(){
+    removeInternalData();
+    keyOf = nullptr;
+    deleteUserData = nullptr;
+}
+
+template<class T>
+inline void RadixHeap<T>::push(T item){
+    long long key = keyOf(item);
+    if(key < last)
+        throw std::invalid_argument("RadixHeap: key is smaller than the last popped/peeked key.");
+    buckets[bucketOf(key)]->add(Entry(key, item));
+    count += 1;
+}
+
+template<class T>
+inline T RadixHeap<T>::pop(){
+    if(count == 0)
+        throw std::underflow_error("Calling to pop with the empty heap.");
+    refill();
+    count -= 1;
+    return buckets[0]->removeAt(buckets[0]->size() - 1).item;
+}
+
+template<class T>
+inline const T RadixHeap<T>::peek(){
+    if(count == 0)
+        throw std::underflow_error("Calling to peek with the empty heap.");
+    refill();
+    return buckets[0]->get(buckets[0]->size() - 1).item;
+}
+
+template<class T>
+inline void RadixHeap<T>::remove(T item, void (*removeItemData)(T)){
+    long long key = keyOf(item);
+    if(key < last) return;
+    XArrayList<Entry>* bucket = buckets[bucketOf(key)];
+    for(int idx=0; idx < bucket->size(); idx++){
+        if(bucket->get(idx).key == key){
+            bucket->removeAt(idx);
+            count -= 1;
+            if(removeItemData != 0) removeItemData(item);
+            return;
+        }
+    }
+}
+
+template<class T>
+inline bool RadixHeap<T>::contains(T item){
+    long long key = keyOf(item);
+    if(key < last) return false;
+    XArrayList<Entry>* bucket = buckets[bucketOf(key)];
+    for(int idx=0; idx < bucket->size(); idx++){
+        if(bucket->get(idx).key == key) return true;
+    }
+    return false;
+}
+
+template<class T>
+inline int RadixHeap<T>::size(){
+    return count;
+}
+
+template<class T>
+inline void RadixHeap<T>::heapify(T array[], int size){
+    clear();
+    for(int idx=0; idx < size; idx++) push(array[idx]);
+}
+
+template<class T>
+inline void RadixHeap<T>::clear(){
+    removeInternalData();
+    allocateBuckets();
+    last = 0;
+    count = 0;
+}
+
+template<class T>
+inline bool RadixHeap<T>::empty(){
+    return count == 0;
+}
+
+/*
+ * toString: items bucket by bucket (not sorted inside a bucket).
+ */
+template<class T>
+inline string RadixHeap<T>::toString(string (*item2str)(T&)){
+    stringstream os;
+    os << "[";
+    bool first = true;
+    for(int b=0; b < NUM_BUCKETS; b++){
+        for(int idx=0; idx < buckets[b]->size(); idx++){
+            if(!first) os << ",";
+            first = false;
+            T& item = buckets[b]->get(idx).item;
+            if(item2str != 0) os << item2str(item);
+            else os << item;
+        }
+    }
+    os << "]";
+    return os.str();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+/*
+ * bucketOf(key): 0 if key == last, else 1 + index of the highest bit where
+ *      key and last differ.
+ */
+template<class T>
+inline int RadixHeap<T>::bucketOf(long long key){
+    unsigned long long diff = (unsigned long long)(key ^ last);
+    if(diff == 0) return 0;
+    return 64 - __builtin_clzll(diff);
+}
+
+/*
+ * refill: make bucket 0 non-empty (count > 0 is required).
+ */
+template<class T>
+inline void RadixHeap<T>::refill(){
+    if(!buckets[0]->empty()) return;
+
+    int b = 1;
+    while(buckets[b]->empty()) b++;
+
+    XArrayList<Entry>* bucket = buckets[b];
+    long long minKey = bucket->get(0).key;
+    for(int idx=1; idx < bucket->size(); idx++){
+        if(bucket->get(idx).key < minKey) minKey = bucket->get(idx).key;
+    }
+
+    last = minKey;
+    while(!bucket->empty()){
+        Entry entry = bucket->removeAt(bucket->size() - 1);
+        buckets[bucketOf(entry.key)]->add(entry); //always a bucket below b
+    }
+}
+
+template<class T>
+inline void RadixHeap<T>::allocateBuckets(){
+    for(int b=0; b < NUM_BUCKETS; b++) buckets[b] = new XArrayList<Entry>();
+}
+
+template<class T>
+inline void RadixHeap<T>::removeInternalData(){
+    if(this->deleteUserData != 0) deleteUserData(this);
+    for(int b=0; b < NUM_BUCKETS; b++){
+        delete buckets[b];
+        buckets[b] = 0;
+    }
+}
+
+template<class T>
+inline void RadixHeap<T>::copyFrom(const RadixHeap<T>& heap){
+    this->keyOf = heap.keyOf;
+    this->deleteUserData = heap.deleteUserData;
+    last = heap.last;
+    count = heap.count;
+    for(int b=0; b < NUM_BUCKETS; b++){
+        XArrayList<Entry>* bucket = heap.buckets[b];
+        for(int idx=0; idx < bucket->size(); idx++) buckets[b]->add(bucket->get(idx));
+    }
+}
+
+#endif /* RADIXHEAP_H */
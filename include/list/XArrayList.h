@@ -37,7 +37,9 @@ public:
         bool (*itemEqual)(T &, T &) = 0,
         int capacity = 10);
     XArrayList(const XArrayList<T> &list);
+    XArrayList(XArrayList<T> &&list);
     XArrayList<T> &operator=(const XArrayList<T> &list);
+    XArrayList<T> &operator=(XArrayList<T> &&list);
     ~XArrayList();
 
     // Inherit from IList: BEGIN
@@ -54,6 +56,8 @@ public:
     string toString(string (*item2str)(T &) = 0);
     // Inherit from IList: BEGIN
 
+    void reserve(int capacity); // room for "capacity" items without reallocation
+
     void println(string (*item2str)(T &) = 0)
     {
         cout << toString(item2str) << endl;
@@ -247,9 +251,29 @@ template <class T>
 inline XArrayList<T>::XArrayList(const XArrayList<T> &list)
 {
     // TODO
+    data = nullptr; // nothing to release yet: copyFrom starts with removeInternalData
+    deleteUserData = nullptr;
     copyFrom(list);
 }
 
+template <class T>
+inline XArrayList<T>::XArrayList(XArrayList<T> &&list)
+{
+    /*
+     * Takes the array of "list" without copying any item. "list" is left
+     * empty, with no array (the next add allocates one).
+     */
+    data = list.data;
+    capacity = list.capacity;
+    count = list.count;
+    itemEqual = list.itemEqual;
+    deleteUserData = list.deleteUserData;
+
+    list.data = nullptr;
+    list.capacity = 0;
+    list.count = 0;
+}
+
 template <class T>
 inline XArrayList<T> &XArrayList<T>::operator=(const XArrayList<T> &list)
 {
@@ -261,6 +285,26 @@ inline XArrayList<T> &XArrayList<T>::operator=(const XArrayList<T> &list)
     return *this;
 }
 
+template <class T>
+inline XArrayList<T> &XArrayList<T>::operator=(XArrayList<T> &&list)
+{
+    if (this != &list) {
+        removeInternalData();
+
+        data = list.data;
+        capacity = list.capacity;
+        count = list.count;
+        itemEqual = list.itemEqual;
+        deleteUserData = list.deleteUserData;
+
+        list.data = nullptr;
+        list.capacity = 0;
+        list.count = 0;
+    }
+
+    return *this;
+}
+
 template <class T>
 inline XArrayList<T>::~XArrayList()
 {
@@ -276,7 +320,7 @@ inline void XArrayList<T>::add(T e)
 {
     // TODO
     ensureCapacity(count + 1);
-    data[count++] = e;
+    data[count++] = std::move(e);
 }
 
 template <class T>
@@ -290,10 +334,10 @@ inline void XArrayList<T>::add(int index, T e)
     ensureCapacity(count + 1);
 
     for (int i = count; i > index; i--) {
-        data[i] = data[i - 1];
+        data[i] = std::move(data[i - 1]);
     }
 
-    data[index] = e;
+    data[index] = std::move(e);
     count++;
 }
 
@@ -303,9 +347,9 @@ inline T XArrayList<T>::removeAt(int index)
     // TODO
     checkIndex(index);
 
-    T removedValue = data[index];
+    T removedValue = std::move(data[index]);
     for (int i = index; i < count - 1; i++) {
-        data[i] = data[i + 1];
+        data[i] = std::move(data[i + 1]);
     }
 
     count--;
@@ -364,6 +408,29 @@ inline T &XArrayList<T>::get(int index) const
     return data[index];
 }
 
+template <class T>
+inline void XArrayList<T>::reserve(int capacity)
+{
+    /**
+     * Reallocates the internal array to exactly "capacity" items when it is
+     * smaller, so that a known number of adds costs one allocation.
+     */
+    if (capacity <= this->capacity) {
+        return;
+    }
+
+    T *newData = new T[capacity];
+    for (int i = 0; i < count; i++) {
+        newData[i] = std::move(data[i]);
+    }
+
+    // the items moved to newData: only the old array is released here,
+    // deleteUserData must not run
+    delete[] data;
+    data = newData;
+    this->capacity = capacity;
+}
+
 template <class T>
 inline int XArrayList<T>::indexOf(T item)
 {
@@ -444,17 +511,12 @@ inline void XArrayList<T>::ensureCapacity(int index)
     }
 
     if (index >= capacity) {
-        int newCapacity = capacity * 1.5, newCount = count;
-
-        T *newData = new T[newCapacity];
-        for (int i = 0 ; i < count; i++) {
-            newData[i] = data[i];
+        // 1.5x growth, but never less than index + 1 (capacity 0 or 1 would not grow)
+        int newCapacity = capacity * 1.5;
+        if (newCapacity <= index) {
+            newCapacity = index + 1;
         }
-
-        removeInternalData();
-        data = newData;
-        capacity = newCapacity;
-        count = newCount;
+        reserve(newCapacity);
     }
 }
 
@@ -0,0 +1,4 @@
+void heapBench1();
+void heapBench(int maxSize);
+void concurrentHeapBench1();
+void concurrentHeapBench(int maxThreads, int opsPerThread);
\ No newline at end of file
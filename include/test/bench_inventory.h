@@ -0,0 +1,2 @@
+void inventoryQueryBench1();
+void inventoryQueryBench(int numProducts, int maxThreads);
\ No newline at end of file
@@ -3,5 +3,6 @@ void tc_huffman1002();
 void tc_huffman1003();
 void tc_huffman1004();
 void tc_huffman1005();
+void tc_huffman1006();
 void tc_compressor1001();
 void tc_compressor1002();
\ No newline at end of file
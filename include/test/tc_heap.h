@@ -1,4 +1,12 @@
 void heapDemo1();
 void heapDemo2();
 void heapDemo3();
-void heapDemo4();
\ No newline at end of file
+void heapDemo4();
+void heapDemo5();
+void heapDemo6();
+void heapDemo7();
+void heapDemo8();
+void heapDemo9();
+void heapDemo10();
+void heapDemo11();
+void heapDemo12();
\ No newline at end of file
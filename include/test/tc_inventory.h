@@ -3,3 +3,21 @@ void tc_inventory1002();
 void tc_inventory1003();
 void tc_inventory1004();
 void tc_inventory1005();
+
+void tc_inventory1007();
+void tc_inventory1008();
+void tc_inventory1009();
+void tc_inventory1010();
+void tc_inventory1011();
+void tc_inventory1012();
+void tc_inventory1013();
+void tc_inventory1014();
+void tc_inventory1015();
+void tc_inventory1016();
+void tc_inventory1017();
+void tc_inventory1018();
+void tc_inventory1019();
+void tc_inventory1020();
+void tc_inventory1021();
+void tc_inventory1022();
+void tc_inventory1023();
\ No newline at end of file
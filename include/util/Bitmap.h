@@ -0,0 +1,246 @@
+/*
+ * File:   Bitmap.h
+ *
+ * Bitmap: a growable array of bits, 64 bits per word.
+ *  + get/set/add        : O(1) (add: amortized)
+ *  + removeAt           : O(n/64), the following bits move down by one
+ *  + countOnes, nextSet : one popcount / count-trailing-zeros per word
+ * Bits past size() in the last word are always 0, so whole-word loops
+ * (countOnes, and/or of two bitmaps) need no masking.
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <memory.h>
+#include <utility>
+
+using namespace std;
+
+class Bitmap
+{
+protected:
+    unsigned long long *words;  //dynamic array of words
+    int capacity;               //size of "words" (in words)
+    int count;                  //number of bits
+
+public:
+    Bitmap(int size=0, bool value=false);
+    Bitmap(const Bitmap &bitmap);
+    Bitmap(Bitmap &&bitmap);            //takes the words; bitmap is left empty
+    Bitmap &operator=(const Bitmap &bitmap);
+    Bitmap &operator=(Bitmap &&bitmap);
+    ~Bitmap();
+
+    int size() const;
+    bool get(int index) const;
+    void set(int index, bool value);
+    void add(bool value);
+    void removeAt(int index);
+    void resize(int size, bool value=false);
+    void reserve(int size);     //room for "size" bits without reallocation
+    void clear();
+
+    int countOnes() const;
+    /* nextSet(from): index of the first 1 at or after "from", -1 if none */
+    int nextSet(int from) const;
+
+    /* raw words, for whole-word loops: (size() + 63)/64 of them */
+    unsigned long long *data() const{
+        return words;
+    }
+    int wordCount() const{
+        return (count + 63)/64;
+    }
+
+    string toString() const;
+
+private:
+    void checkIndex(int index) const;
+    void ensureCapacity(int minWords);
+    void clearTail();
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+inline Bitmap::Bitmap(int size, bool value){
+    if(size < 0) size = 0;
+    capacity = (size + 63)/64;
+    if(capacity < 1) capacity = 1;
+    words = new unsigned long long[capacity];
+    memset(words, value ? 0xff : 0, capacity*sizeof(unsigned long long));
+    count = size;
+    clearTail();
+}
+
+inline Bitmap::Bitmap(const Bitmap &bitmap){
+    capacity = bitmap.capacity;
+    count = bitmap.count;
+    words = new unsigned long long[capacity];
+    memcpy(words, bitmap.words, capacity*sizeof(unsigned long long));
+}
+
+inline Bitmap &Bitmap::operator=(const Bitmap &bitmap){
+    if(this != &bitmap){
+        delete []words;
+        capacity = bitmap.capacity;
+        count = bitmap.count;
+        words = new unsigned long long[capacity];
+        memcpy(words, bitmap.words, capacity*sizeof(unsigned long long));
+    }
+    return *this;
+}
+
+inline Bitmap::Bitmap(Bitmap &&bitmap): Bitmap(){
+    swap(words, bitmap.words);
+    swap(capacity, bitmap.capacity);
+    swap(count, bitmap.count);
+}
+
+inline Bitmap &Bitmap::operator=(Bitmap &&bitmap){
+    if(this != &bitmap){
+        swap(words, bitmap.words);
+        swap(capacity, bitmap.capacity);
+        swap(count, bitmap.count);
+        bitmap.clear();
+    }
+    return *this;
+}
+
+inline Bitmap::~Bitmap(){
+    delete []words;
+}
+
+inline int Bitmap::size() const{
+    return count;
+}
+
+inline bool Bitmap::get(int index) const{
+    checkIndex(index);
+    return (words[index >> 6] >> (index & 63)) & 1ULL;
+}
+
+inline void Bitmap::set(int index, bool value){
+    checkIndex(index);
+    unsigned long long mask = 1ULL << (index & 63);
+    if(value) words[index >> 6] |= mask;
+    else words[index >> 6] &= ~mask;
+}
+
+inline void Bitmap::add(bool value){
+    ensureCapacity(count/64 + 1);
+    count += 1;
+    set(count - 1, value);
+}
+
+inline void Bitmap::removeAt(int index){
+    checkIndex(index);
+    int word = index >> 6;
+    int bit = index & 63;
+    unsigned long long low = (bit == 0) ? 0 : (words[word] & ((1ULL << bit) - 1));
+    unsigned long long high = (bit == 63) ? 0 : ((words[word] >> (bit + 1)) << bit);
+    words[word] = low | high;
+
+    int last = wordCount() - 1;
+    for(int idx = word; idx < last; idx++){
+        words[idx] |= (words[idx + 1] & 1ULL) << 63;
+        words[idx + 1] >>= 1;
+    }
+    count -= 1;
+    clearTail();
+}
+
+inline void Bitmap::resize(int size, bool value){
+    if(size < 0) size = 0;
+    if(size < count){
+        count = size;
+        clearTail();
+        return;
+    }
+    ensureCapacity((size + 63)/64);
+    if(value){
+        for(int idx = count; idx < size && (idx & 63) != 0; idx++){
+            words[idx >> 6] |= 1ULL << (idx & 63);
+        }
+        for(int word = (count + 63)/64; word < (size + 63)/64; word++) words[word] = ~0ULL;
+    }
+    count = size;
+    clearTail();
+}
+
+inline void Bitmap::reserve(int size){
+    ensureCapacity((size + 63)/64);
+}
+
+inline void Bitmap::clear(){
+    memset(words, 0, capacity*sizeof(unsigned long long));
+    count = 0;
+}
+
+inline int Bitmap::countOnes() const{
+    int ones = 0;
+    int n = wordCount();
+    for(int word = 0; word < n; word++) ones += __builtin_popcountll(words[word]);
+    return ones;
+}
+
+inline int Bitmap::nextSet(int from) const{
+    if(from < 0) from = 0;
+    if(from >= count) return -1;
+    int word = from >> 6;
+    unsigned long long bits = words[word] & (~0ULL << (from & 63));
+    int n = wordCount();
+    while(true){
+        if(bits != 0) return (word << 6) + __builtin_ctzll(bits);
+        word += 1;
+        if(word >= n) return -1;
+        bits = words[word];
+    }
+}
+
+inline string Bitmap::toString() const{
+    stringstream os;
+    os << "[";
+    for(int idx = 0; idx < count; idx++) os << (get(idx) ? '1' : '0');
+    os << "]";
+    return os.str();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+inline void Bitmap::checkIndex(int index) const{
+    if(index < 0 || index >= count)
+        throw out_of_range("Index is out of range!");
+}
+
+inline void Bitmap::ensureCapacity(int minWords){
+    if(minWords <= capacity) return;
+    int newCapacity = capacity*2;
+    if(newCapacity < minWords) newCapacity = minWords;
+
+    unsigned long long *newWords = new unsigned long long[newCapacity];
+    memcpy(newWords, words, capacity*sizeof(unsigned long long));
+    memset(newWords + capacity, 0, (newCapacity - capacity)*sizeof(unsigned long long));
+    delete []words;
+    words = newWords;
+    capacity = newCapacity;
+}
+
+/*
+ * clearTail: zero the bits past "count" (keeps whole-word loops exact).
+ */
+inline void Bitmap::clearTail(){
+    int used = wordCount();
+    if((count & 63) != 0) words[used - 1] &= (1ULL << (count & 63)) - 1;
+    for(int word = used; word < capacity; word++) words[word] = 0;
+}
+
+#endif /* BITMAP_H */
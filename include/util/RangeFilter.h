@@ -0,0 +1,256 @@
+/*
+ * File:   RangeFilter.h
+ *
+ * RangeFilter: vectorized predicates over contiguous columns.
+ *  + selectRange  : bit i = (minValue <= values[i] <= maxValue), doubles
+ *  + selectAtLeast: bit i = (values[i] >= minValue), ints
+ *  + toIndices    : the positions of the 1 bits, in order
+ * The bits are written 64 per word, in the layout of Bitmap::data(): word
+ * w holds elements 64w .. 64w + 63, bits past n in the last word are 0.
+ *
+ * Kernels: scalar, SSE2 (2 doubles / 4 ints per compare), AVX2 (4 / 8)
+ * and AVX-512 (8 / 16). Each is compiled with __attribute__((target)),
+ * so the file builds with the default flags on any x86-64 compiler; the
+ * best kernel the CPU supports is picked once, at the first call
+ * (__builtin_cpu_supports). Other architectures get the scalar kernel.
+ * A NaN value is never selected, as with the scalar comparisons.
+ */
+
+#ifndef RANGEFILTER_H
+#define RANGEFILTER_H
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RANGEFILTER_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+class RangeFilter
+{
+public:
+    enum Level { SCALAR = 0, SSE2 = 1, AVX2 = 2, AVX512 = 3, BEST = -1 };
+
+    static Level best();                // best level of this CPU
+    static bool supports(Level level);
+    static const char *levelName(Level level);
+
+    static void selectRange(const double *values, int n, double minValue, double maxValue,
+                            unsigned long long *words, Level level = BEST);
+    static void selectAtLeast(const int *values, int n, int minValue,
+                              unsigned long long *words, Level level = BEST);
+    /* toIndices: write the positions of the 1 bits of words (n bits) to
+     * "indices" (room for n ints); return how many */
+    static int toIndices(const unsigned long long *words, int n, int *indices);
+
+private:
+    typedef unsigned long long (*RangeKernel)(const double *values, double minValue, double maxValue);
+    typedef unsigned long long (*AtLeastKernel)(const int *values, int minValue);
+
+    // each kernel: the 64-bit word of 64 consecutive values
+    static unsigned long long rangeScalar(const double *values, double minValue, double maxValue);
+    static unsigned long long atLeastScalar(const int *values, int minValue);
+#ifdef RANGEFILTER_X86
+    static unsigned long long rangeSse2(const double *values, double minValue, double maxValue);
+    static unsigned long long atLeastSse2(const int *values, int minValue);
+    static unsigned long long rangeAvx2(const double *values, double minValue, double maxValue);
+    static unsigned long long atLeastAvx2(const int *values, int minValue);
+    static unsigned long long rangeAvx512(const double *values, double minValue, double maxValue);
+    static unsigned long long atLeastAvx512(const int *values, int minValue);
+#endif
+    static RangeKernel rangeKernel(Level level);
+    static AtLeastKernel atLeastKernel(Level level);
+};
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+inline RangeFilter::Level RangeFilter::best(){
+    static const Level level = []{
+#ifdef RANGEFILTER_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f")) return AVX512;
+        if(__builtin_cpu_supports("avx2")) return AVX2;
+        if(__builtin_cpu_supports("sse2")) return SSE2;
+#endif
+        return SCALAR;
+    }();
+    return level;
+}
+
+inline bool RangeFilter::supports(Level level){
+    return level <= best();
+}
+
+inline const char *RangeFilter::levelName(Level level){
+    if(level == BEST) level = best();
+    switch(level){
+        case SSE2: return "sse2";
+        case AVX2: return "avx2";
+        case AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+inline void RangeFilter::selectRange(const double *values, int n, double minValue, double maxValue,
+                                     unsigned long long *words, Level level){
+    RangeKernel kernel = rangeKernel(level);
+    int full = n/64;
+    for(int w=0; w < full; w++) words[w] = kernel(values + 64*w, minValue, maxValue);
+    if(n % 64 != 0){
+        unsigned long long bits = 0;
+        for(int i = 64*full; i < n; i++){
+            if(values[i] >= minValue && values[i] <= maxValue) bits |= 1ULL << (i & 63);
+        }
+        words[full] = bits;
+    }
+}
+
+inline void RangeFilter::selectAtLeast(const int *values, int n, int minValue,
+                                       unsigned long long *words, Level level){
+    AtLeastKernel kernel = atLeastKernel(level);
+    int full = n/64;
+    for(int w=0; w < full; w++) words[w] = kernel(values + 64*w, minValue);
+    if(n % 64 != 0){
+        unsigned long long bits = 0;
+        for(int i = 64*full; i < n; i++){
+            if(values[i] >= minValue) bits |= 1ULL << (i & 63);
+        }
+        words[full] = bits;
+    }
+}
+
+inline int RangeFilter::toIndices(const unsigned long long *words, int n, int *indices){
+    int count = 0;
+    int numWords = (n + 63)/64;
+    for(int w=0; w < numWords; w++){
+        unsigned long long bits = words[w];
+        while(bits != 0){
+            indices[count++] = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+
+inline RangeFilter::RangeKernel RangeFilter::rangeKernel(Level level){
+    if(level == BEST || !supports(level)) level = best();
+#ifdef RANGEFILTER_X86
+    if(level == AVX512) return &RangeFilter::rangeAvx512;
+    if(level == AVX2) return &RangeFilter::rangeAvx2;
+    if(level == SSE2) return &RangeFilter::rangeSse2;
+#endif
+    return &RangeFilter::rangeScalar;
+}
+
+inline RangeFilter::AtLeastKernel RangeFilter::atLeastKernel(Level level){
+    if(level == BEST || !supports(level)) level = best();
+#ifdef RANGEFILTER_X86
+    if(level == AVX512) return &RangeFilter::atLeastAvx512;
+    if(level == AVX2) return &RangeFilter::atLeastAvx2;
+    if(level == SSE2) return &RangeFilter::atLeastSse2;
+#endif
+    return &RangeFilter::atLeastScalar;
+}
+
+inline unsigned long long RangeFilter::rangeScalar(const double *values, double minValue, double maxValue){
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i++){
+        bits |= (unsigned long long)(values[i] >= minValue && values[i] <= maxValue) << i;
+    }
+    return bits;
+}
+
+inline unsigned long long RangeFilter::atLeastScalar(const int *values, int minValue){
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i++){
+        bits |= (unsigned long long)(values[i] >= minValue) << i;
+    }
+    return bits;
+}
+
+#ifdef RANGEFILTER_X86
+__attribute__((target("sse2")))
+inline unsigned long long RangeFilter::rangeSse2(const double *values, double minValue, double maxValue){
+    __m128d low = _mm_set1_pd(minValue);
+    __m128d high = _mm_set1_pd(maxValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 2){
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d in = _mm_and_pd(_mm_cmpge_pd(x, low), _mm_cmple_pd(x, high));
+        bits |= (unsigned long long)_mm_movemask_pd(in) << i;
+    }
+    return bits;
+}
+
+__attribute__((target("sse2")))
+inline unsigned long long RangeFilter::atLeastSse2(const int *values, int minValue){
+    __m128i low = _mm_set1_epi32(minValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 4){
+        __m128i x = _mm_loadu_si128((const __m128i *)(values + i));
+        // x >= min  <=>  !(min > x)
+        int below = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(low, x)));
+        bits |= (unsigned long long)(~below & 0xf) << i;
+    }
+    return bits;
+}
+
+__attribute__((target("avx2")))
+inline unsigned long long RangeFilter::rangeAvx2(const double *values, double minValue, double maxValue){
+    __m256d low = _mm256_set1_pd(minValue);
+    __m256d high = _mm256_set1_pd(maxValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 4){
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d in = _mm256_and_pd(_mm256_cmp_pd(x, low, _CMP_GE_OQ), _mm256_cmp_pd(x, high, _CMP_LE_OQ));
+        bits |= (unsigned long long)_mm256_movemask_pd(in) << i;
+    }
+    return bits;
+}
+
+__attribute__((target("avx2")))
+inline unsigned long long RangeFilter::atLeastAvx2(const int *values, int minValue){
+    __m256i low = _mm256_set1_epi32(minValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 8){
+        __m256i x = _mm256_loadu_si256((const __m256i *)(values + i));
+        int below = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(low, x)));
+        bits |= (unsigned long long)(~below & 0xff) << i;
+    }
+    return bits;
+}
+
+__attribute__((target("avx512f")))
+inline unsigned long long RangeFilter::rangeAvx512(const double *values, double minValue, double maxValue){
+    __m512d low = _mm512_set1_pd(minValue);
+    __m512d high = _mm512_set1_pd(maxValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 8){
+        __m512d x = _mm512_loadu_pd(values + i);
+        __mmask8 in = _mm512_cmp_pd_mask(x, low, _CMP_GE_OQ) & _mm512_cmp_pd_mask(x, high, _CMP_LE_OQ);
+        bits |= (unsigned long long)in << i;
+    }
+    return bits;
+}
+
+__attribute__((target("avx512f")))
+inline unsigned long long RangeFilter::atLeastAvx512(const int *values, int minValue){
+    __m512i low = _mm512_set1_epi32(minValue);
+    unsigned long long bits = 0;
+    for(int i=0; i < 64; i += 16){
+        __m512i x = _mm512_loadu_si512((const void *)(values + i));
+        bits |= (unsigned long long)_mm512_cmpge_epi32_mask(x, low) << i;
+    }
+    return bits;
+}
+#endif
+
+#endif /* RANGEFILTER_H */
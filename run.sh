@@ -1 +1 @@
-g++ -g -I include -I src -std=c++17 src/test/* src/main.cpp -o main && ./main
\ No newline at end of file
+g++ -g -I include -I src -std=c++17 src/test/* src/main.cpp -o main -pthread && ./main
\ No newline at end of file
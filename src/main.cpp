@@ -4,11 +4,13 @@
 #include <string>
 #include "test/tc_xmap.h"
 #include "test/tc_heap.h"
+#include "test/bench_heap.h"
+#include "test/bench_inventory.h"
 #include "test/tc_compressor.h"
 
 using namespace std;
 
-void (*func_ptr[18])() = {
+void (*func_ptr[30])() = {
     hashDemo1,
     hashDemo2,
     hashDemo3,
@@ -26,7 +28,19 @@ void (*func_ptr[18])() = {
     tc_huffman1004,
     tc_huffman1005,
     tc_compressor1001,
-    tc_compressor1002
+    tc_compressor1002,
+    heapDemo5,
+    heapDemo6,
+    heapDemo7,
+    heapDemo8,
+    heapDemo9,
+    heapDemo10,
+    heapDemo11,
+    heapDemo12,
+    tc_huffman1006,
+    heapBench1,
+    concurrentHeapBench1,
+    inventoryQueryBench1
 };
 
 void run(int func_idx)
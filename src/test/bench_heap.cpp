@@ -0,0 +1,115 @@
+#include "test/bench_heap.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "heap/Heap.h"
+#include "heap/DaryHeap.h"
+#include "heap/ConcurrentHeap.h"
+#include "heap/MultiQueue.h"
+
+using namespace std;
+
+/*
+ * Push n random ints, then pop all of them.
+ * Return throughput in million operations (push + pop) per second.
+ */
+template<class H>
+static double pushPopThroughput(H& heap, int* data, int n){
+    auto start = chrono::steady_clock::now();
+    for(int idx=0; idx < n; idx++) heap.push(data[idx]);
+    long long checksum = 0;
+    while(!heap.empty()) checksum += heap.pop();
+    auto stop = chrono::steady_clock::now();
+
+    double seconds = chrono::duration<double>(stop - start).count();
+    if(checksum == 42) cout << "";     //keep the pops alive
+    return (2.0*n)/seconds/1e6;
+}
+
+void heapBench(int maxSize){
+    cout << "push/pop throughput (Mops/s)" << endl;
+    cout << setw(12) << "n"
+         << setw(12) << "Heap"
+         << setw(12) << "D=2"
+         << setw(12) << "D=4"
+         << setw(12) << "D=8" << endl;
+
+    mt19937 engine(2025);
+    for(long long n = 1000; n <= maxSize; n *= 10){
+        int* data = new int[n];
+        for(long long idx=0; idx < n; idx++) data[idx] = (int)engine();
+
+        Heap<int> binary;
+        DaryHeap<int, 2> dary2;
+        DaryHeap<int, 4> dary4;
+        DaryHeap<int, 8> dary8;
+
+        cout << fixed << setprecision(2)
+             << setw(12) << n
+             << setw(12) << pushPopThroughput(binary, data, n)
+             << setw(12) << pushPopThroughput(dary2, data, n)
+             << setw(12) << pushPopThroughput(dary4, data, n)
+             << setw(12) << pushPopThroughput(dary8, data, n) << endl;
+        delete []data;
+    }
+}
+
+void heapBench1(){
+    heapBench(100000000);
+}
+
+/*
+ * Prefill the queue, then every thread alternates push(random) and tryPop
+ * for opsPerThread operations.
+ * Return throughput in million operations per second (all threads).
+ */
+static double mixedThroughput(IConcurrentHeap<int>& queue, int numThreads, int opsPerThread){
+    mt19937 engine(2025);
+    for(int idx=0; idx < 1000*numThreads; idx++) queue.push((int)(engine() & 0xffffff));
+
+    thread** workers = new thread*[numThreads];
+    auto start = chrono::steady_clock::now();
+    for(int t=0; t < numThreads; t++){
+        workers[t] = new thread([&queue, t, opsPerThread](){
+            mt19937 local(t + 1);
+            int item;
+            for(int op=0; op < opsPerThread; op += 2){
+                queue.push((int)(local() & 0xffffff));
+                queue.tryPop(item);
+            }
+        });
+    }
+    for(int t=0; t < numThreads; t++){
+        workers[t]->join();
+        delete workers[t];
+    }
+    auto stop = chrono::steady_clock::now();
+    delete []workers;
+
+    double seconds = chrono::duration<double>(stop - start).count();
+    return ((double)numThreads*opsPerThread)/seconds/1e6;
+}
+
+void concurrentHeapBench(int maxThreads, int opsPerThread){
+    cout << "mixed push/tryPop throughput (Mops/s), "
+         << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << setw(12) << "threads"
+         << setw(12) << "strict"
+         << setw(12) << "relaxed" << endl;
+
+    for(int numThreads = 1; numThreads <= maxThreads; numThreads *= 2){
+        ConcurrentHeap<int> strict;
+        MultiQueue<int> relaxed(0, numThreads);
+
+        cout << fixed << setprecision(2)
+             << setw(12) << numThreads
+             << setw(12) << mixedThroughput(strict, numThreads, opsPerThread)
+             << setw(12) << mixedThroughput(relaxed, numThreads, opsPerThread) << endl;
+    }
+}
+
+void concurrentHeapBench1(){
+    concurrentHeapBench(64, 1000000);
+}
@@ -0,0 +1,63 @@
+#include "test/bench_inventory.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "app/inventory.h"
+
+using namespace std;
+
+/*
+ * Run the same query "repeat" times.
+ * Return the average time of one query in milliseconds.
+ */
+static double queryMillis(const InventoryManager& inventory, int numThreads, int repeat, int& found){
+    auto start = chrono::steady_clock::now();
+    for(int idx=0; idx < repeat; idx++){
+        List1D<string> names = (numThreads == 0)
+            ? inventory.query("weight", 100, 900, 5, true)
+            : inventory.queryParallel("weight", 100, 900, 5, true, numThreads);
+        found = names.size();
+    }
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(stop - start).count()/repeat;
+}
+
+void inventoryQueryBench(int numProducts, int maxThreads){
+    mt19937 engine(2025);
+    uniform_int_distribution<int> weight(0, 999);
+    uniform_int_distribution<int> quantity(0, 9);
+    InventoryManager inventory;
+    for(int idx=0; idx < numProducts; idx++){
+        InventoryAttribute arr[] = { InventoryAttribute("weight", weight(engine)) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "P" + to_string(idx), quantity(engine));
+    }
+
+    int found = 0;
+    queryMillis(inventory, 0, 1, found);   //builds the index
+    double sequential = queryMillis(inventory, 0, 5, found);
+    cout << "query weight in [100, 900], quantity >= 5 over " << numProducts << " products: "
+         << found << " found, " << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << setw(12) << "threads"
+         << setw(12) << "ms"
+         << setw(12) << "speedup" << endl;
+    cout << fixed << setprecision(2)
+         << setw(12) << "query"
+         << setw(12) << sequential
+         << setw(12) << 1.0 << endl;
+
+    for(int numThreads = 1; numThreads <= maxThreads; numThreads *= 2){
+        int parallelFound = 0;
+        double ms = queryMillis(inventory, numThreads, 5, parallelFound);
+        cout << setw(12) << numThreads
+             << setw(12) << ms
+             << setw(12) << sequential/ms;
+        if(parallelFound != found) cout << "  (found " << parallelFound << "!)";
+        cout << endl;
+    }
+}
+
+void inventoryQueryBench1(){
+    inventoryQueryBench(2000000, 64);
+}
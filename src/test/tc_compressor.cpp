@@ -106,6 +106,38 @@ void tc_huffman1005() {
     }
 }
 
+void tc_huffman1006() {
+    XArrayList<pair<char, int>> symbolFreqs;
+    const string symbols = "ABCDEFGHIJ";
+    int n = symbols.size();
+    for (int i = 0; i < n; ++i) {
+        symbolFreqs.add(make_pair(symbols[i], (i + 1) * 2));
+    }
+
+    HTree heapTree;
+    Heap<HNode*> heap(&HTree::nodeCompare);
+    heapTree.build(symbolFreqs, heap);
+
+    HTree radixTree;
+    RadixHeap<HNode*> radix(&HTree::nodeKey);
+    radixTree.build(symbolFreqs, radix);
+
+    xMap<char, string> heapCodes(&charHashFunc);
+    xMap<char, string> radixCodes(&charHashFunc);
+    heapTree.generateCodes(heapCodes);
+    radixTree.generateCodes(radixCodes);
+
+    int heapBits = 0, radixBits = 0;
+    for (int i = 0; i < n; ++i) {
+        char ch = symbols[i];
+        heapBits += symbolFreqs.get(i).second * heapCodes.get(ch).length();
+        radixBits += symbolFreqs.get(i).second * radixCodes.get(ch).length();
+        cout << ch << ": " << heapCodes.get(ch) << " / " << radixCodes.get(ch)
+             << " decodes as: " << radixTree.decode(radixCodes.get(ch)) << endl;
+    }
+    cout << "Encoded length (Heap / RadixHeap): " << heapBits << " / " << radixBits << endl;
+}
+
 void tc_compressor1001() {    
     InventoryManager manager;
     List1D<InventoryAttribute> attrs;
@@ -2,6 +2,13 @@
  #include <string>
  #include <sstream>
  #include "heap/Heap.h"
+ #include "heap/IndexedHeap.h"
+ #include "heap/DaryHeap.h"
+ #include "heap/PairingHeap.h"
+ #include "heap/LeftistHeap.h"
+ #include "heap/ConcurrentHeap.h"
+ #include "heap/MultiQueue.h"
+ #include <thread>
  #include "util/Point.h"
  #include "util/sampleFunc.h"
  
@@ -138,5 +145,196 @@ void heapDemo4(){
     list.println();
 }
 
- 
- 
\ No newline at end of file
+void heapDemo5(){
+    //reorder queue: days until stock-out, reprioritized through handles
+    IndexedHeap<int> heap;
+    int days[] = {12, 7, 30, 3, 18};
+    int handles[5];
+    for(int idx=0; idx < 5; idx++) handles[idx] = heap.insert(days[idx]);
+    cout << "Initial heap: " << heap.toString() << endl;
+
+    heap.decreaseKey(handles[2], 1);   //30 -> 1
+    heap.increaseKey(handles[3], 25);  //3 -> 25
+    heap.update(handles[0], 5);        //12 -> 5
+    cout << "After reprioritizing: " << heap.toString() << endl;
+
+    cout << "Removed by handle: " << heap.removeHandle(handles[1]) << endl;
+    cout << "Handle still valid? " << heap.containsHandle(handles[1]) << endl;
+    heap.insert(9); //reuses the slot, not the handle
+    cout << "Still valid after another insert? " << heap.containsHandle(handles[1]) << endl;
+
+    cout << "Pop order: ";
+    while(!heap.empty()) cout << heap.pop() << " ";
+    cout << endl;
+}
+
+void heapDemo6(){
+    int array[] = {50, 20, 15, 10, 8, 6, 7, 23, 42, 1, 19};
+    DaryHeap<int, 4> minHeap;
+    minHeap.heapify(array, 11);
+    cout << "4-ary min heap: " << minHeap.toString() << endl;
+
+    DaryHeap<int, 8> maxHeap(maxHeapComparator);
+    for(int idx=0; idx < 11; idx++) maxHeap.push(array[idx]);
+    cout << "8-ary max heap: " << maxHeap.toString() << endl;
+
+    cout << "Pop order (4-ary): ";
+    while(!minHeap.empty()) cout << minHeap.pop() << " ";
+    cout << endl;
+}
+
+struct ReorderJob{
+    string sku;
+    int daysLeft;
+    ReorderJob(const string& sku, int daysLeft): sku(sku), daysLeft(daysLeft){}
+    bool operator<(const ReorderJob& other) const{ return daysLeft < other.daysLeft; }
+    bool operator>(const ReorderJob& other) const{ return daysLeft > other.daysLeft; }
+    friend ostream& operator<<(ostream& os, const ReorderJob& job){
+        return os << job.sku << ":" << job.daysLeft;
+    }
+};
+void heapDemo7(){
+    //payload by value: non-trivial (std::string) and no default constructor
+    Heap<ReorderJob> heap;
+    heap.reserve(64);
+    for(int idx=0; idx < 40; idx++){
+        heap.push(ReorderJob("SKU-" + to_string(idx), (idx*37) % 41));
+    }
+    cout << "Size: " << heap.size() << endl;
+    cout << "First 5 jobs: ";
+    for(int idx=0; idx < 5; idx++){
+        cout << heap.pop() << " ";
+    }
+    cout << endl;
+
+    Heap<ReorderJob> copy(heap);
+    cout << "Popped from copy: " << copy.pop().sku << ", size: " << copy.size() << endl;
+}
+
+void heapDemo8(){
+    XArrayList<int> list;
+    int values[] = {42, 7, 19, 88, 3, 61, 25, 90, 14, 56, 33, 71};
+    for (int v : values) {
+        list.add(v);
+    }
+
+    Heap<int> maxHeap(maxHeapComparator);
+    XArrayList<int> top = maxHeap.topK(list, 3);
+    cout << "Top 3 (list untouched): ";
+    top.println();
+    list.println();
+
+    Heap<int> minHeap;
+    minHeap.partialSort(list, 4);
+    cout << "Smallest 4 first: ";
+    list.println();
+
+    minHeap.heapsortNoPrint(list);
+    cout << "Sorted in place: ";
+    list.println();
+}
+
+void heapDemo9(){
+    int north[] = {50, 20, 15, 10, 8};
+    XArrayList<int> south;
+    int values[] = {6, 7, 23, 42, 1};
+    for (int v : values) {
+        south.add(v);
+    }
+
+    Heap<int> northHeap;
+    northHeap.push(99); //replaced by heapify
+    northHeap.heapify(north, 5);
+    cout << "North: " << northHeap.toString() << endl;
+
+    Heap<int> southHeap;
+    southHeap.heapify(south.begin(), south.end());
+    cout << "South: " << southHeap.toString() << endl;
+
+    northHeap.merge(std::move(southHeap));
+    cout << "Merged: " << northHeap.toString() << ", south size: " << southHeap.size() << endl;
+    cout << "Pop order: ";
+    while (!northHeap.empty()) cout << northHeap.pop() << " ";
+    cout << endl;
+}
+
+void heapDemo10(){
+    //per-warehouse queues melded into one
+    int hanoi[] = {12, 4, 30, 9};
+    int saigon[] = {7, 21, 2, 15, 11};
+
+    PairingHeap<int> pairingA, pairingB;
+    pairingA.heapify(hanoi, 4);
+    pairingB.heapify(saigon, 5);
+    pairingA.meld(pairingB);
+    cout << "Pairing heap melded (" << pairingA.size() << " items, other: " << pairingB.size() << "): ";
+    while(!pairingA.empty()) cout << pairingA.pop() << " ";
+    cout << endl;
+
+    LeftistHeap<int> leftistA(maxHeapComparator), leftistB(maxHeapComparator);
+    leftistA.heapify(hanoi, 4);
+    leftistB.heapify(saigon, 5);
+    leftistA.meld(leftistB);
+    leftistA.remove(21);
+    cout << "Leftist max heap melded, 21 removed: ";
+    while(!leftistA.empty()) cout << leftistA.pop() << " ";
+    cout << endl;
+}
+
+void heapDemo11(){
+    //four pickers push orders concurrently, then the queues are drained
+    ConcurrentHeap<int> strict;
+    MultiQueue<int> relaxed(0, 4);
+    XArrayList<thread*> pickers;
+    for(int t=0; t < 4; t++){
+        pickers.add(new thread([t, &strict, &relaxed](){
+            for(int order = t; order < 1000; order += 4){
+                strict.push(order);
+                relaxed.push(order);
+            }
+        }));
+    }
+    for(int t=0; t < 4; t++){
+        pickers.get(t)->join();
+        delete pickers.get(t);
+    }
+    cout << "Pushed: strict " << strict.size() << ", relaxed " << relaxed.size() << endl;
+
+    int order, previous = -1;
+    bool sorted = true;
+    while(strict.tryPop(order)){
+        if(order < previous) sorted = false;
+        previous = order;
+    }
+    cout << "Strict queue drained in order: " << (sorted ? "yes" : "no") << endl;
+
+    long long sum = 0;
+    int popped = 0;
+    while(relaxed.tryPop(order)){
+        sum += order;
+        popped += 1;
+    }
+    cout << "Relaxed queue drained: " << popped << " orders, sum " << sum << endl;
+    cout << "Both empty: " << (strict.empty() && relaxed.empty() ? "yes" : "no") << endl;
+}
+
+void heapDemo12(){
+    //next reorder candidates for a dashboard, without popping the queue
+    int stock[] = {42, 7, 19, 3, 25, 11, 30, 5, 16, 8};
+    Heap<int> reorder;
+    reorder.heapify(stock, 10);
+    cout << "Heap (array order): " << reorder.toString() << endl;
+    
+    cout << "Pop order (ordered iterator): ";
+    for (Heap<int>::OrderedIterator it = reorder.orderedBegin(); it != reorder.orderedEnd(); it++) {
+        cout << *it << " ";
+    }
+    cout << endl;
+    
+    cout << "Next 4 candidates: " << reorder.peekFirst(4).toString() << endl;
+    cout << "Heap unchanged: " << reorder.toString() << ", size: " << reorder.size() << endl;
+    
+    Heap<int> maxHeap(maxHeapComparator);
+    maxHeap.heapify(stock, 10);
+    cout << "Largest 3 (max heap): " << maxHeap.peekFirst(3).toString() << endl;
+}
@@ -167,4 +167,522 @@ void tc_inventory1006(){
     inventory.removeDuplicates();
     cout << "\nAfter removing duplicates:" << endl;
     cout << inventory.toString() << endl;
-}
\ No newline at end of file
+}
+void tc_inventory1007(){
+    // columnar storage: rows with missing and repeated attributes
+    InventoryManager inventory;
+
+    InventoryAttribute arrA[] = { InventoryAttribute("weight", 10), InventoryAttribute("height", 156) };
+    InventoryAttribute arrB[] = { InventoryAttribute("depth", 24), InventoryAttribute("weight", 20),
+                                  InventoryAttribute("weight", 5) };
+    InventoryAttribute arrC[] = { InventoryAttribute("color", 2) };
+    InventoryAttribute arrD[] = { InventoryAttribute("weight", 15), InventoryAttribute("height", 140) };
+    inventory.addProduct(List1D<InventoryAttribute>(arrA, 2), "Product A", 50);
+    inventory.addProduct(List1D<InventoryAttribute>(arrB, 3), "Product B", 30);
+    inventory.addProduct(List1D<InventoryAttribute>(arrC, 1), "Product C", 20);
+    inventory.addProduct(List1D<InventoryAttribute>(arrD, 2), "Product D", 40);
+    cout << inventory.toString() << endl;
+
+    cout << "weight in [0, 12], quantity >= 0: " << inventory.query("weight", 0, 12, 0, true) << endl;
+    cout << "weight in [0, 100], descending: " << inventory.query("weight", 0, 100, 0, false) << endl;
+    cout << "height in [0, 200], quantity >= 45: " << inventory.query("height", 0, 200, 45, true) << endl;
+    cout << "unknown attribute: " << inventory.query("volume", 0, 100, 0, true) << endl;
+
+    inventory.removeProduct(1);
+    InventoryManager copy(inventory);
+    inventory.updateQuantity(0, 1);
+    cout << "\nAfter removing Product B (copy taken before updating Product A):" << endl;
+    cout << copy.toString() << endl;
+    cout << "Product A quantity: " << inventory.getProductQuantity(0)
+         << " (copy: " << copy.getProductQuantity(0) << ")" << endl;
+    cout << "weight in [0, 100]: " << copy.query("weight", 0, 100, 0, true) << endl;
+}
+
+void tc_inventory1008(){
+    // interned attribute names: equal names share one id
+    InventoryAttribute a("weight", 10), b("weight", 20), c("height", 156);
+    cout << "same name, same id: " << (a.name.getId() == b.name.getId() ? "yes" : "no") << endl;
+    cout << "different names, different ids: " << (a.name.getId() != c.name.getId() ? "yes" : "no") << endl;
+    cout << "id back to name: " << AttributeNames::nameOf(c.name.getId()) << endl;
+    cout << "lookup without interning: " << AttributeNames::find("volume") << endl;
+    cout << "compare with a string: " << (a.name == "weight" ? "equal" : "different") << endl;
+    cout << "attribute: " << a << ", " << sizeof(InventoryAttribute) << " bytes" << endl;
+}
+
+void tc_inventory1009(){
+    // sorted secondary index: built by the first query, then kept up to date
+    InventoryManager inventory;
+    double weights[] = { 12, 7, 30, 7, 18 };
+    for (int i = 0; i < 5; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", weights[i]) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + string(1, (char)('A' + i)), 10 * (i + 1));
+    }
+    cout << "weight in [5, 20], ascending: " << inventory.query("weight", 5, 20, 0, true) << endl;
+    cout << "weight in [5, 20], descending: " << inventory.query("weight", 5, 20, 0, false) << endl;
+
+    InventoryAttribute arrF[] = { InventoryAttribute("weight", 9) };
+    inventory.addProduct(List1D<InventoryAttribute>(arrF, 1), "Product F", 60);
+    inventory.removeProduct(0);
+    cout << "after adding F (9) and removing A (12): " << inventory.query("weight", 5, 20, 0, true) << endl;
+    cout << "quantity >= 40: " << inventory.query("weight", 0, 100, 40, true) << endl;
+    cout << "empty range: " << inventory.query("weight", 20, 10, 0, true) << endl;
+}
+
+void tc_inventory1010(){
+    // catalogue merge: many copies of few products
+    InventoryManager inventory;
+    long long totalQuantity = 0;
+    for (int i = 0; i < 100000; i++) {
+        int product = (i * 7919) % 1000;
+        InventoryAttribute arr[] = { InventoryAttribute("weight", product % 50),
+                                     InventoryAttribute("height", product / 50) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 2), "Product " + to_string(product), 1 + i % 3);
+        totalQuantity += 1 + i % 3;
+    }
+    inventory.removeDuplicates();
+
+    long long quantityAfter = 0;
+    for (int i = 0; i < inventory.size(); i++) {
+        quantityAfter += inventory.getProductQuantity(i);
+    }
+    cout << "products after removeDuplicates: " << inventory.size() << endl;
+    cout << "total quantity kept: " << (quantityAfter == totalQuantity ? "yes" : "no") << endl;
+    cout << "first: " << inventory.getProductName(0) << " " << inventory.getProductAttributes(0)
+         << " x" << inventory.getProductQuantity(0) << endl;
+}
+
+void tc_inventory1011(){
+    // tombstones: removals are marked, the storage is compacted later
+    InventoryManager inventory;
+    for (int i = 0; i < 50000; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i % 100) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + to_string(i), i % 7);
+    }
+    // remove every product with an odd number, one at a time
+    for (int i = 1; i < inventory.size(); i++) {
+        inventory.removeProduct(i);
+    }
+    cout << "after removing odd products: " << inventory.size() << " left, [1] = "
+         << inventory.getProductName(1) << ", last = " << inventory.getProductName(inventory.size() - 1) << endl;
+
+    int indicesArray[] = { 2, 0, 2, 4 };
+    inventory.removeProducts(List1D<int>(indicesArray, 4));
+    cout << "after removeProducts([2, 0, 2, 4]): " << inventory.size() << " left, first three: "
+         << inventory.getProductName(0) << ", " << inventory.getProductName(1) << ", "
+         << inventory.getProductName(2) << endl;
+    List1D<string> found = inventory.query("weight", 0, 0, 6, true);
+    cout << "weight in [0, 0], quantity >= 6: " << found.size() << " products, first "
+         << found.get(0) << ", last " << found.get(found.size() - 1) << endl;
+
+    try {
+        int badArray[] = { 1, inventory.size() };
+        inventory.removeProducts(List1D<int>(badArray, 2));
+    } catch (const out_of_range &e) {
+        cout << "invalid index: " << e.what() << ", size still " << inventory.size() << endl;
+    }
+}
+
+void tc_inventory1012(){
+    // mergeAll: rows moved into one presized result
+    InventoryManager parts[3];
+    for (int p = 0; p < 3; p++) {
+        for (int i = 0; i < 4; i++) {
+            int n = i * 3 + p;
+            InventoryAttribute arr[] = { InventoryAttribute("weight", n % 5), InventoryAttribute("depth", p) };
+            parts[p].addProduct(List1D<InventoryAttribute>(arr, 2), "Product " + to_string(n % 6), 1 + p);
+        }
+    }
+    InventoryManager *inputs[] = { &parts[0], &parts[1], &parts[2] };
+    InventoryManager all = InventoryManager::mergeAll(inputs, 3);
+    cout << "concatenated: " << all.size() << " products, inputs left with "
+         << parts[0].size() + parts[1].size() + parts[2].size() << endl;
+    cout << "first: " << all.getProductName(0) << " " << all.getProductAttributes(0)
+         << ", last: " << all.getProductName(all.size() - 1) << " " << all.getProductAttributes(all.size() - 1) << endl;
+
+    // sorted inputs: one k-way merge by name, duplicates summed
+    string names[3][3] = { { "apple", "kiwi", "pear" }, { "apple", "fig", "pear" }, { "banana", "kiwi", "pear" } };
+    for (int p = 0; p < 3; p++) {
+        for (int i = 0; i < 3; i++) {
+            InventoryAttribute arr[] = { InventoryAttribute("weight", names[p][i] == "pear" ? p : 1) };
+            parts[p].addProduct(List1D<InventoryAttribute>(arr, 1), names[p][i], 10 * (p + 1));
+        }
+    }
+    InventoryManager sorted = InventoryManager::mergeAll(inputs, 3, true);
+    cout << "sorted merge: " << sorted.getProductNames() << endl;
+    cout << "quantities: " << sorted.getQuantities() << endl;
+
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 1) };
+    parts[0].addProduct(List1D<InventoryAttribute>(arr, 1), "zucchini", 1);
+    parts[0].addProduct(List1D<InventoryAttribute>(arr, 1), "apple", 1);
+    try {
+        InventoryManager::mergeAll(inputs, 3, true);
+    } catch (const invalid_argument &e) {
+        cout << "unsorted input: " << e.what() << ", size still " << parts[0].size() << endl;
+    }
+}
+
+void tc_inventory1013(){
+    // views: slices of one inventory, nothing copied
+    InventoryManager inventory;
+    for (int i = 0; i < 10; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", (i * 7) % 10) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + to_string(i), i);
+    }
+    InventoryView train, test;
+    inventory.split(train, test, 0.75);
+    cout << "split 0.75: " << train.size() << " + " << test.size()
+         << ", test[0] = " << test.getProductName(0) << " " << test.getProductAttributes(0) << endl;
+    cout << "train query weight in [0, 5]: " << train.query("weight", 0, 5, 0, true) << endl;
+    cout << "test query weight in [0, 9] desc: " << test.query("weight", 0, 9, 0, false) << endl;
+
+    InventoryView left, right;
+    train.split(left, right, 0.5);
+    cout << "train split 0.5: " << left.getProductName(left.size() - 1) << " | "
+         << right.getProductName(0) << ".." << right.getProductName(right.size() - 1) << endl;
+
+    int rows[] = { 9, 3, 5, 0, 3 };
+    InventoryView picked(inventory, rows, 5);
+    cout << "picked query weight in [0, 5], quantity >= 3: " << picked.query("weight", 0, 5, 3, true) << endl;
+    cout << "picked slice(1, 3): " << picked.slice(1, 3).getProductName(0) << ", quantity "
+         << picked.slice(1, 3).getProductQuantity(2) << endl;
+
+    try {
+        picked.slice(3, 4);
+    } catch (const out_of_range &e) {
+        cout << "slice(3, 4) of 5: " << e.what() << endl;
+    }
+}
+
+void tc_inventory1014(){
+    // attributesOf / names: read the products in place
+    InventoryAttribute arr1[] = { InventoryAttribute("weight", 10), InventoryAttribute("depth", 24), InventoryAttribute("weight", 12) };
+    InventoryAttribute arr2[] = { InventoryAttribute("height", 156) };
+    InventoryManager inventory;
+    inventory.addProduct(List1D<InventoryAttribute>(arr1, 3), "Product A", 50);
+    inventory.addProduct(List1D<InventoryAttribute>(), "Product B", 0);
+    inventory.addProduct(List1D<InventoryAttribute>(arr2, 1), "Product C", 30);
+    inventory.removeProduct(1);
+
+    for (int i = 0; i < inventory.size(); i++) {
+        AttributeSpan attributes = inventory.attributesOf(i);
+        cout << inventory.names()[i] << " (" << attributes.size() << "):";
+        for (InventoryAttribute attribute : attributes) {
+            cout << " " << attribute;
+        }
+        cout << endl;
+    }
+    cout << "attributesOf(0)[2]: " << inventory.attributesOf(0)[2]
+         << ", nameAt(1) = " << inventory.attributesOf(0).nameAt(1) << endl;
+    cout << "names:";
+    for (const string &name : inventory.names()) {
+        cout << " " << name;
+    }
+    cout << endl;
+
+    try {
+        inventory.attributesOf(0).get(3);
+    } catch (const out_of_range &e) {
+        cout << "attributesOf(0).get(3): " << e.what() << endl;
+    }
+}
+
+void tc_inventory1015(){
+    // moves: the lists and the storage change owner, nothing is copied
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10), InventoryAttribute("height", 156) };
+    List1D<InventoryAttribute> row(arr, 2);
+    List2D<InventoryAttribute> matrix;
+    matrix.setRow(0, std::move(row));
+    cout << "moved-from row: " << row << endl; // left empty
+    matrix.setRow(1, List1D<InventoryAttribute>(arr + 1, 1));
+    row = matrix.getRow(1);
+    cout << "matrix: " << matrix << ", row: " << row << endl;
+
+    List2D<InventoryAttribute> moved(std::move(matrix));
+    cout << "moved matrix: " << moved.rows() << " rows, moved-from: " << matrix << endl;
+    List1D<InventoryAttribute> taken;
+    taken = std::move(row);
+    row.add(arr[0]);
+    matrix.setRow(0, row);
+    cout << "reused: " << matrix << ", taken: " << taken << endl;
+
+    InventoryManager inventory;
+    for (int i = 0; i < 5; i++) {
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 2), "Product " + to_string(i), i);
+    }
+    inventory.removeProduct(2);
+    InventoryManager owner(std::move(inventory));
+    cout << "owner: " << owner.size() << " products, moved-from: " << inventory.size() << endl;
+
+    inventory.addProduct(List1D<InventoryAttribute>(arr + 1, 1), "Product X", 7);
+    cout << "moved-from reused: " << inventory.getProductName(0) << " "
+         << inventory.query("height", 100, 200, 0, true) << endl;
+
+    inventory = std::move(owner);
+    cout << "after move assignment: " << inventory.size() << " products, last "
+         << inventory.getProductName(inventory.size() - 1) << ", weight query "
+         << inventory.query("weight", 0, 100, 3, true) << endl;
+}
+
+void tc_inventory1016(){
+    // queryParallel: same result as query, whatever the number of threads
+    InventoryManager inventory;
+    for (int i = 0; i < 100000; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", (i * 37) % 1000), InventoryAttribute("weight", i % 3) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 2), "Product " + to_string(i), i % 10);
+    }
+    for (int i = 0; i < 1000; i++) {
+        inventory.removeProduct(i * 50);
+    }
+
+    List1D<string> ascending = inventory.query("weight", 1, 800, 4, true);
+    List1D<string> descending = inventory.query("weight", 1, 800, 4, false);
+    cout << "query: " << ascending.size() << " products, first " << ascending.get(0)
+         << ", last " << ascending.get(ascending.size() - 1) << endl;
+    int threads[] = { 1, 3, 8, 0 };
+    for (int t = 0; t < 4; t++) {
+        List1D<string> up = inventory.queryParallel("weight", 1, 800, 4, true, threads[t]);
+        List1D<string> down = inventory.queryParallel("weight", 1, 800, 4, false, threads[t]);
+        bool same = up.size() == ascending.size() && down.size() == descending.size();
+        for (int i = 0; same && i < up.size(); i++) {
+            same = up.get(i) == ascending.get(i) && down.get(i) == descending.get(i);
+        }
+        cout << "queryParallel, " << (threads[t] == 0 ? string("hardware") : to_string(threads[t]))
+             << " threads: " << (same ? "same result" : "DIFFERENT") << endl;
+    }
+    List1D<string> few = inventory.queryParallel("weight", 999, 999, 0, false, 8);
+    cout << "small range (sequential): " << few.size() << " products, first " << few.get(0) << endl;
+}
+
+void tc_inventory1017(){
+    // RangeFilter: every kernel the CPU supports gives the scalar bits
+    const int n = 1000;
+    double values[n];
+    int quantities[n];
+    for (int i = 0; i < n; i++) {
+        values[i] = (i * 7919) % 100 - 10;
+        quantities[i] = (i * 31) % 20 - 5;
+    }
+    unsigned long long expected[16], expectedQ[16], bits[16], bitsQ[16];
+    RangeFilter::selectRange(values, n, 0, 49.5, expected, RangeFilter::SCALAR);
+    RangeFilter::selectAtLeast(quantities, n, 3, expectedQ, RangeFilter::SCALAR);
+    bool agree = true;
+    RangeFilter::Level levels[] = { RangeFilter::SSE2, RangeFilter::AVX2, RangeFilter::AVX512 };
+    for (int l = 0; l < 3; l++) {
+        if (!RangeFilter::supports(levels[l])) {
+            continue;
+        }
+        RangeFilter::selectRange(values, n, 0, 49.5, bits, levels[l]);
+        RangeFilter::selectAtLeast(quantities, n, 3, bitsQ, levels[l]);
+        agree = agree && memcmp(bits, expected, sizeof(bits[0]) * 16) == 0
+                      && memcmp(bitsQ, expectedQ, sizeof(bitsQ[0]) * 16) == 0;
+    }
+    int indices[n];
+    int count = RangeFilter::toIndices(expected, n, indices);
+    cout << "kernels agree: " << (agree ? "yes" : "NO") << ", " << count << " values in [0, 49.5], first "
+         << indices[0] << ", " << indices[1] << ", " << indices[2] << endl;
+
+    // a dense query (most products in range) goes through the bitmaps
+    InventoryManager inventory;
+    for (int i = 0; i < 40; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i % 8), InventoryAttribute("weight", i % 5) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 2), "P" + to_string(i), i % 4);
+    }
+    inventory.removeProduct(0);
+    cout << "dense query weight in [2, 6], quantity >= 2: " << inventory.query("weight", 2, 6, 2, true) << endl;
+}
+
+void tc_inventory1018(){
+    // aggregate / groupBy: one pass over the columns, no row copied
+    InventoryManager inventory;
+    for (int i = 0; i < 12; i++) {
+        List1D<InventoryAttribute> attributes;
+        attributes.add(InventoryAttribute("weight", i * 2.5));
+        if (i % 3 == 0) {
+            attributes.add(InventoryAttribute("weight", 100 + i)); // repeated name: both values count
+        }
+        if (i % 4 == 0) {
+            attributes.add(InventoryAttribute("depth", i));
+        }
+        inventory.addProduct(attributes, "Product " + to_string(i), i);
+    }
+    inventory.removeProduct(11);
+
+    const char *ops[] = { "sum", "min", "max", "avg", "count" };
+    InventoryManager::AggregateOp codes[] = { InventoryManager::SUM, InventoryManager::MIN, InventoryManager::MAX,
+                                              InventoryManager::AVG, InventoryManager::COUNT };
+    for (int k = 0; k < 5; k++) {
+        cout << ops[k] << "(weight) = " << inventory.aggregate("weight", codes[k])
+             << ", in [0, 20]: " << inventory.aggregate("weight", codes[k], 0, 20)
+             << ", quantity: " << inventory.aggregateQuantity(codes[k]) << endl;
+    }
+    cout << "avg(height) = " << inventory.aggregate("height", InventoryManager::AVG)
+         << ", count(height) = " << inventory.aggregate("height", InventoryManager::COUNT) << endl;
+    cout << "groupBy(weight, 0, 10, 3): " << inventory.groupBy("weight", 0, 10, 3) << endl;
+
+    // many products: the same results with threads
+    InventoryManager large;
+    for (int i = 0; i < 200000; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i % 1000) };
+        large.addProduct(List1D<InventoryAttribute>(arr, 1), "P", i % 10);
+    }
+    for (int i = 0; i < 200000 / 4; i++) {
+        large.removeProduct(i * 3);
+    }
+    bool same = true;
+    for (int k = 0; k < 5; k++) {
+        same = same && large.aggregate("weight", codes[k], 100, 899) == large.aggregate("weight", codes[k], 100, 899, 4)
+                    && large.aggregateQuantity(codes[k]) == large.aggregateQuantity(codes[k], 3);
+    }
+    List1D<AttributeGroup> groups = large.groupBy("weight", 0, 250, 4);
+    List1D<AttributeGroup> threaded = large.groupBy("weight", 0, 250, 4, 8);
+    for (int b = 0; b < 4; b++) {
+        same = same && groups.get(b) == threaded.get(b);
+    }
+    cout << "large: sum(quantity) = " << (long long)large.aggregateQuantity(InventoryManager::SUM)
+         << ", groups " << groups << ", threads agree: " << (same ? "yes" : "NO") << endl;
+
+    try {
+        inventory.groupBy("weight", 0, 0, 3);
+    } catch (const invalid_argument &e) {
+        cout << "groupBy width 0: " << e.what() << endl;
+    }
+}
+
+void tc_inventory1019(){
+    // QueryBuilder: AND/OR of predicates, planned from the most selective index
+    InventoryManager inventory;
+    for (int i = 0; i < 20; i++) {
+        List1D<InventoryAttribute> attributes;
+        attributes.add(InventoryAttribute("weight", i % 7));
+        if (i % 3 == 0) {
+            attributes.add(InventoryAttribute("depth", i));
+        }
+        inventory.addProduct(attributes, (i % 2 == 0 ? "Tool " : "Part ") + to_string(i), i * 5 % 13);
+    }
+    inventory.removeProduct(0);
+
+    QueryBuilder query = inventory.select()
+                             .whereAttribute("weight", 2, 4).whereQuantity(5)
+                             .orWhere()
+                             .whereNamePrefix("Part").whereAttribute("depth", 10, 20);
+    cout << "names: " << query.names() << endl;
+    cout << "rows: " << query.rows() << endl;
+    cout << query.explain() << endl;
+
+    // top-k: heaviest 3 after the first one, ties in product order
+    query.orderByAttribute("weight", false).offset(1).limit(3);
+    cout << "top-k: " << query.names() << endl;
+    cout << query.explain() << endl;
+
+    cout << "by quantity: " << inventory.select().whereNamePrefix("Tool 1").orderByQuantity().names() << endl;
+    cout << "unknown attribute: " << inventory.select().whereAttribute("height", 0, 10).names() << endl;
+
+    try {
+        inventory.select().limit(-2);
+    } catch (const invalid_argument &e) {
+        cout << "limit -2: " << e.what() << endl;
+    }
+}
+
+void tc_inventory1020(){
+    // name index: findByName (hash) and findByPrefix (sorted names), kept up to date
+    InventoryManager inventory;
+    const char *names[] = { "Bolt", "Nut", "Bolt M4", "Washer", "Bolt", "Nut M4", "Bracket" };
+    for (int i = 0; i < 7; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), names[i], i + 1);
+    }
+    cout << "findByName(Bolt): " << inventory.findByName("Bolt") << endl;
+    cout << "findByPrefix(B): " << inventory.findByPrefix("B") << endl;
+    cout << "findByPrefix(Nut): " << inventory.findByPrefix("Nut") << endl;
+    cout << "findByName(Screw): " << inventory.findByName("Screw") << endl;
+
+    // the indices follow removals and additions
+    inventory.removeProduct(0);
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 9) };
+    inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Bolt", 10);
+    cout << "after remove/add, findByName(Bolt): " << inventory.findByName("Bolt") << endl;
+
+    // merge: the result has its own index
+    InventoryManager other;
+    other.addProduct(List1D<InventoryAttribute>(arr, 1), "Bolt M4", 3);
+    InventoryManager merged = InventoryManager::merge(inventory, other);
+    cout << "merged, findByPrefix(Bolt): " << merged.findByPrefix("Bolt") << endl;
+
+    // the name index drives a prefix query when it is the most selective
+    cout << merged.select().whereNamePrefix("Bolt M").whereQuantity(1).explain() << endl;
+}
+
+void tc_inventory1021(){
+    // applyBatch: updates, additions and removals on the indices before the batch
+    InventoryManager inventory;
+    for (int i = 0; i < 6; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + to_string(i), 10 + i);
+    }
+    // built indexes are merged once at the end of the batch
+    cout << "before: " << inventory.query("weight", 0, 10, 0, true) << endl;
+
+    InventoryBatch batch;
+    InventoryAttribute light[] = { InventoryAttribute("weight", 0.5) };
+    InventoryAttribute heavy[] = { InventoryAttribute("weight", 7), InventoryAttribute("depth", 2) };
+    batch.add(List1D<InventoryAttribute>(heavy, 2), "Product 7", 1);
+    batch.update(1, 99);
+    batch.remove(0);
+    batch.add(List1D<InventoryAttribute>(light, 1), "Product 1", 3);
+    batch.update(4, 40);
+    batch.remove(3);
+    batch.update(4, 44); // the last update wins
+    cout << "operations: " << batch.size() << ", additions: " << batch.additions() << endl;
+
+    inventory.applyBatch(batch);
+    cout << inventory.toString() << endl;
+    cout << "query: " << inventory.query("weight", 0, 10, 0, true) << endl;
+    cout << "findByName(Product 1): " << inventory.findByName("Product 1") << endl;
+
+    // an invalid index: nothing is applied
+    InventoryBatch invalid;
+    invalid.add(List1D<InventoryAttribute>(light, 1), "Product 8", 1);
+    invalid.remove(inventory.size());
+    try {
+        inventory.applyBatch(invalid);
+    } catch (const out_of_range &e) {
+        cout << "invalid batch: " << e.what() << ", size still " << inventory.size() << endl;
+    }
+}
+
+void tc_inventory1022(){
+    // NaN attribute values: in no range, and kept out of the sorted index
+    InventoryManager inventory;
+    for (int i = 0; i < 200; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("w", i % 7 == 0 ? NAN : i % 13) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "P" + to_string(i), 1);
+    }
+    List1D<string> names = inventory.query("w", 0, 5, 0, true);
+    int withNaN = 0;
+    for (int i = 0; i < names.size(); i++) {
+        withNaN += std::isnan(inventory.getProductAttributes(stoi(names.get(i).substr(1))).get(0).value);
+    }
+    cout << "query(w, 0, 5): " << names.size() << " products, " << withNaN << " with NaN" << endl;
+    cout << "count(w in [0, 5]): " << inventory.aggregate("w", InventoryManager::COUNT, 0, 5) << endl;
+
+    // the index stays sorted when NaN values are added after it is built
+    InventoryAttribute nan[] = { InventoryAttribute("w", NAN) };
+    inventory.addProduct(List1D<InventoryAttribute>(nan, 1), "P200", 1);
+    cout << "after adding NaN: " << inventory.query("w", 12, 20, 0, false).size() << " products in [12, 20]" << endl;
+}
+
+void tc_inventory1023(){
+    // groupBy: a value just below the end is counted in the last bucket,
+    // even when (value - start) / width rounds up to the bucket count
+    InventoryManager inventory;
+    double end = -5.0 + 1.0 * 4;
+    double values[] = { -5.0, -3.5, std::nextafter(end, -INFINITY), end };
+    for (int i = 0; i < 4; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("t", values[i]) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "P" + to_string(i), i + 1);
+    }
+    List1D<AttributeGroup> groups = inventory.groupBy("t", -5.0, 1.0, 4);
+    cout << "groupBy(t, -5, 1, 4): " << groups << endl;
+    cout << "last bucket: " << groups.get(3).count << " product(s), quantity " << groups.get(3).quantity << endl;
+}